@@ -0,0 +1,40 @@
+function varargout = actor(op,id,fun,varargin)
+% objects of the actors on this worker (see MatlabPool.createActor)
+%   op  : 'create', 'call', 'fetch' or 'destroy'
+%   id  : id of the actor
+%   fun : constructor or method, empty for 'fetch' and 'destroy'
+
+persistent objects
+if isempty(objects)
+    objects = containers.Map('KeyType','uint64','ValueType','any');
+end
+
+if strcmp(op,'create')
+    objects(id) = feval(fun,varargin{:});
+    return
+end
+
+if ~isKey(objects,id)
+    error('MatlabPoolWorker:ActorMiss', ...
+        'the actor %d does not exist on this worker',id)
+end
+
+switch op
+    case 'call'
+        obj = objects(id);
+        if isa(obj,'handle')
+            [varargout{1:nargout}] = feval(fun,obj,varargin{:});
+        else
+            % a value object returns its new state first
+            result = cell(1,nargout + 1);
+            [result{:}] = feval(fun,obj,varargin{:});
+            objects(id) = result{1};
+            varargout = result(2:end);
+        end
+    case 'fetch'
+        varargout{1} = objects(id);
+    case 'destroy'
+        remove(objects,id);
+end
+
+end
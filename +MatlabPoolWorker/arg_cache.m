@@ -0,0 +1,36 @@
+function args = arg_cache(cache,args)
+% resolves the arguments of a job which are cached by this worker.
+% The fields of "cache" are:
+%   keys  : cell array, one entry per argument. 'S<digest>' stores
+%           the argument, 'R<digest>' replaces the argument by the
+%           stored value and an empty entry leaves it unchanged
+%   evict : cell array of digests which can be removed
+%   reset : true if all stored values must be removed
+
+persistent store
+if isempty(store) || cache.reset
+    store = containers.Map('KeyType','char','ValueType','any');
+end
+
+for i = 1:numel(cache.keys)
+    key = cache.keys{i};
+    if isempty(key)
+        continue
+    end
+    digest = key(2:end);
+    if key(1) == 'S'
+        store(digest) = args{i};
+    elseif isKey(store,digest)
+        args{i} = store(digest);
+    else
+        error('MatlabPoolWorker:CacheMiss', ...
+            'argument %d is not cached by this worker',i)
+    end
+end
+
+evict = cache.evict(isKey(store,cache.evict));
+if ~isempty(evict)
+    remove(store,evict);
+end
+
+end
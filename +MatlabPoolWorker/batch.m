@@ -0,0 +1,31 @@
+function [results,errors] = batch(fun,nlhs,args)
+% evaluates a batch of small jobs of the same function with a single
+% call of the worker. The pool splits the results into the jobs.
+%   fun     : name of the job function
+%   nlhs    : number of return values of every job
+%   args    : cell array, one cell array of arguments for every job
+%   results : cell array, one cell array of return values for every job
+%   errors  : cell array, the error report of a failed job, otherwise
+%             empty
+
+n = numel(args);
+results = cell(1,n);
+errors = cell(1,n);
+for i = 1:n
+    try
+        if nlhs == 0
+            % like a single job, a function without return values is
+            % called without output arguments
+            feval(fun,args{i}{:});
+            results{i} = {};
+        else
+            result = cell(1,nlhs);
+            [result{:}] = feval(fun,args{i}{:});
+            results{i} = result;
+        end
+    catch e
+        errors{i} = getReport(e,'basic');
+    end
+end
+
+end
@@ -0,0 +1,14 @@
+function result = fetch_result(id)
+% return values of a worker-resident result (see 
+% MatlabPool.submitResident)
+%   id     : id of the job
+%   result : cell array of the return values
+
+store = MatlabPoolWorker.keep_results();
+if ~isKey(store,id)
+    error('MatlabPoolWorker:ResultMiss', ...
+        'the return values of job %d are not stored on this worker',id)
+end
+result = store(id);
+
+end
@@ -0,0 +1,35 @@
+function args = job_results(deps,args)
+% replaces arguments by return values of other jobs, which are stored
+% on this worker (job graph, see MatlabPool.submitAfter). The fields
+% of "deps" are:
+%   keep    : id of this job if its return values are stored, empty
+%             otherwise (see MatlabPoolWorker.keep_results)
+%   index   : indices of the replaced arguments
+%   job     : ids of the jobs of the stored return values
+%   output  : indices of the return values
+%   release : ids of jobs whose return values can be removed
+%   reset   : true if all return values must be removed
+%   resident: number of return values of a worker-resident result
+%             (see MatlabPool.submitResident), empty otherwise
+
+store = MatlabPoolWorker.keep_results();
+for i = 1:numel(deps.index)
+    if ~isKey(store,deps.job(i))
+        error('MatlabPoolWorker:ResultMiss', ...
+            'the return values of job %d are not stored on this worker',deps.job(i))
+    end
+    result = store(deps.job(i));
+    args{deps.index(i)} = result{deps.output(i)};
+end
+
+% the released values can be inputs of this job
+if deps.reset
+    remove(store,keys(store));
+end
+for id = reshape(deps.release,1,[])
+    if isKey(store,id)
+        remove(store,id);
+    end
+end
+
+end
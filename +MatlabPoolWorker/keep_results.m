@@ -0,0 +1,17 @@
+function store = keep_results(id,result)
+% store of the return values of jobs on this worker, the map is a 
+% handle object, so "job_results" can modify it
+%   id     : id of the job
+%   result : cell array of the return values
+
+persistent map
+if isempty(map)
+    map = containers.Map('KeyType','uint64','ValueType','any');
+end
+
+if nargin == 2
+    map(id) = result;
+end
+store = map;
+
+end
@@ -0,0 +1,33 @@
+function result = reduce(fun, ids, varargin)
+% pairwise reduction of partial results (see MatlabPool.mapReduce)
+%   fun      : reduce function, two arguments and one return value, 
+%              a name or the text of an anonymous function
+%   ids      : ids of the partial results, which are stored on this 
+%              worker, they are removed after the reduction
+%   varargin : partial results
+
+store = MatlabPoolWorker.keep_results();
+for id = reshape(ids,1,[])
+    if isKey(store,id)
+        remove(store,id);
+    end
+end
+
+% e.g. '@(a,b)a+b' from func2str
+fun = str2func(fun);
+
+values = varargin;
+while numel(values) > 1
+    n = floor(numel(values)/2);
+    reduced = cell(1,ceil(numel(values)/2));
+    for i = 1:n
+        reduced{i} = feval(fun,values{2*i-1},values{2*i});
+    end
+    if numel(values) > 2*n
+        reduced{end} = values{end};
+    end
+    values = reduced;
+end
+result = values{1};
+
+end
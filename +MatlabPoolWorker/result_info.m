@@ -0,0 +1,15 @@
+function info = result_info(result)
+% metadata of the return values of a worker-resident result
+%   result : cell array of the return values
+%   info   : struct array with the fields "size", "class" and "bytes"
+
+info = struct('size',{},'class',{},'bytes',{});
+for i = 1:numel(result)
+    value = result{i}; %#ok<NASGU>
+    w = whos('value');
+    info(i).size = w.size;
+    info(i).class = w.class;
+    info(i).bytes = w.bytes;
+end
+
+end
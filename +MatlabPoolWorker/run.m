@@ -0,0 +1,40 @@
+function varargout = run(spec, fun, varargin)
+% worker side dispatcher of the MatlabPool. The pool calls this
+% function instead of "fun" if a job needs extra work on the
+% worker, e.g. writing the result into a shared output sink.
+%   spec : struct, every field describes one extra task
+%   fun  : name of the job function
+
+if isfield(spec,'cache')
+    varargin = MatlabPoolWorker.arg_cache(spec.cache,varargin);
+end
+
+if isfield(spec,'template')
+    varargin = MatlabPoolWorker.template_args(spec.template,varargin);
+end
+
+if isfield(spec,'deps')
+    varargin = MatlabPoolWorker.job_results(spec.deps,varargin);
+end
+
+varargout = cell(1,nargout);
+if isfield(spec,'deps') && ~isempty(spec.deps.resident)
+    % worker-resident result: keep the return values, return their 
+    % metadata only
+    result = cell(1,spec.deps.resident);
+    [result{:}] = feval(fun,varargin{:});
+    MatlabPoolWorker.keep_results(spec.deps.keep,result);
+    varargout{1} = MatlabPoolWorker.result_info(result);
+    return
+elseif isfield(spec,'sink')
+    result = feval(fun,varargin{:});
+    MatlabPoolWorker.write_sink(spec.sink,result);
+else
+    [varargout{1:nargout}] = feval(fun,varargin{:});
+end
+
+if isfield(spec,'deps') && ~isempty(spec.deps.keep)
+    MatlabPoolWorker.keep_results(spec.deps.keep,varargout);
+end
+
+end
@@ -0,0 +1,40 @@
+function args = template_args(tmpl,args)
+% appends the fixed arguments of a job template, which are pinned on
+% this worker. The fields of "tmpl" are:
+%   id      : id of the template, empty if the job has no template
+%   store   : true if the fixed arguments are pinned on this worker
+%   fixed   : cell array of the fixed arguments, sent with the job if
+%             "store" is true or the template is unregistered
+%   release : ids of templates which can be removed
+%   reset   : true if all templates must be removed
+
+persistent store
+if isempty(store) || tmpl.reset
+    store = containers.Map('KeyType','uint64','ValueType','any');
+end
+
+for id = reshape(tmpl.release,1,[])
+    if isKey(store,id)
+        remove(store,id);
+    end
+end
+
+if isempty(tmpl.id)
+    return
+end
+
+if tmpl.store
+    store(tmpl.id) = tmpl.fixed;
+elseif ~isempty(tmpl.fixed)
+    % job of an unregistered template
+    args = [args, tmpl.fixed];
+    return
+elseif ~isKey(store,tmpl.id)
+    error('MatlabPoolWorker:TemplateMiss', ...
+        'the template %d is not pinned on this worker',tmpl.id)
+end
+
+fixed = store(tmpl.id);
+args = [args, fixed];
+
+end
@@ -0,0 +1,24 @@
+function write_sink(sink,value)
+% writes "value" into a slice of a shared output sink, i.e. a file
+% which is mapped into the memory of the client. The fields of
+% "sink" are:
+%   file   : path of the shared memory file
+%   class  : class name of the array, e.g. 'uint8'
+%   dims   : dimensions of the whole array
+%   offset : zero based offset of the slice
+%   size   : dimensions of the slice
+
+dims = double(sink.dims);
+offset = double(sink.offset);
+slice = double(sink.size);
+
+value_size = ones(1,numel(slice));
+assert(ndims(value) <= numel(slice),'Assertion: ''ndims(value) <= numel(slice)''')
+value_size(1:ndims(value)) = size(value);
+assert(isequal(value_size,slice),'Assertion: ''isequal(size(value),slice)''')
+
+m = memmapfile(sink.file,'Format',{sink.class,dims,'A'},'Writable',true);
+idx = arrayfun(@(o,n)o+1:o+n,offset,slice,'UniformOutput',false);
+m.Data(1).A(idx{:}) = cast(value,sink.class);
+
+end
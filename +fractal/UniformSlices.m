@@ -46,6 +46,22 @@ methods(Access = public)
                        'dim',size(x)),A);
     end
     
+    function [offset,slice_size] = getSlicesRegion(obj)
+        % zero based offset and size of every slice, one row for each
+        % slice (same order as "getSlices")
+        n = numel(obj.dim);
+        first = cell(1,n);
+        for i = 1:n
+            first{i} = cumsum([0,obj.slices_dim{i}(1:end-1)]);
+        end
+        grid_first = cell(1,n);
+        grid_size = cell(1,n);
+        [grid_first{:}] = ndgrid(first{:});
+        [grid_size{:}] = ndgrid(obj.slices_dim{:});
+        offset = cell2mat(cellfun(@(x)x(:),grid_first,'UniformOutput',false));
+        slice_size = cell2mat(cellfun(@(x)x(:),grid_size,'UniformOutput',false));
+    end
+    
     function A = mergeSlices(obj,s)
         assert(numel(s)==prod(obj.slices),'Assertion: ''numel(s)==prod(obj.slices)''')
         A = cell2mat(reshape(s(:),obj.slices));
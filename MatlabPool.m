@@ -1,6 +1,6 @@
 classdef MatlabPool < handle
     
-    properties(Constant,Access = private)
+    properties(Constant,Access = {?MatlabPoolHandle})
         cmd_resize       = uint8(0)
         cmd_submit       = uint8(1)
         cmd_wait         = uint8(2)
@@ -10,6 +10,53 @@ classdef MatlabPool < handle
         cmd_cancel       = uint8(6)
         cmd_size         = uint8(7)
         cmd_clear        = uint8(8)
+        cmd_createSink   = uint8(9)
+        cmd_submitSink   = uint8(10)
+        cmd_waitSink     = uint8(11)
+        cmd_createGather = uint8(12)
+        cmd_submitGather = uint8(13)
+        cmd_waitGather   = uint8(14)
+        cmd_argumentCache = uint8(15)
+        cmd_statusPool   = uint8(16)
+        cmd_memoize      = uint8(17)
+        cmd_invalidateMemo = uint8(18)
+        cmd_coalesce     = uint8(19)
+        cmd_batching     = uint8(20)
+        cmd_registerTemplate = uint8(21)
+        cmd_submitTemplate = uint8(22)
+        cmd_unregisterTemplate = uint8(23)
+        cmd_submitQuiet  = uint8(24)
+        cmd_outputLimit  = uint8(25)
+        cmd_readOutput   = uint8(26)
+        cmd_broadcast    = uint8(27)
+        cmd_waitBroadcast = uint8(28)
+        cmd_initEval     = uint8(29)
+        cmd_initFeval    = uint8(30)
+        cmd_clearInit    = uint8(31)
+        cmd_submitAfter  = uint8(32)
+        cmd_submitResident = uint8(33)
+        cmd_fetchResult  = uint8(34)
+        cmd_freeResult   = uint8(35)
+        cmd_createActor  = uint8(36)
+        cmd_callActor    = uint8(37)
+        cmd_fetchActor   = uint8(38)
+        cmd_destroyActor = uint8(39)
+        cmd_mapReduce    = uint8(40)
+        cmd_distribute   = uint8(41)
+        cmd_spmd         = uint8(42)
+        cmd_spmdReduce   = uint8(43)
+        cmd_freeDistributed = uint8(44)
+        cmd_scheduler    = uint8(45)
+        cmd_speculation  = uint8(46)
+        cmd_submitCost   = uint8(47)
+        cmd_addLane      = uint8(48)
+        cmd_submitLane   = uint8(49)
+        cmd_statusLanes  = uint8(50)
+        cmd_onPool       = uint8(51)
+        cmd_closePool    = uint8(52)
+        cmd_autoscale    = uint8(53)
+        cmd_cpuPinning   = uint8(54)
+        cmd_recycling    = uint8(55)
         
         options = {'-nojvm', '-nosplash'}
     end
@@ -22,13 +69,33 @@ classdef MatlabPool < handle
         end
         
         function shutdown()
+            % removes also the named pools
             clear('MatlabPoolMEX')
         end
+
+        function h = pool(name,val,options)
+            % handle of a named pool with its own engine options and
+            % settings, e.g. a few engines with jvm for I/O:
+            %   io = MatlabPool.pool('io',2,{'-nosplash'});
+            %   id = io.submit('fun',1,args...);
+            if nargin < 3
+                options = MatlabPool.options;
+            end
+            h = MatlabPoolHandle(name,options);
+            h.resize(val);
+        end
         
         function jobid = submit(fun,nof_out,varargin)
             jobid = MatlabPoolMEX(MatlabPool.cmd_submit,fun,uint64(nof_out),varargin{:});
         end
         
+        function jobid = submitCost(cost,fun,nof_out,varargin)
+            % like "submit", "cost" is the expected runtime of the job
+            % in seconds (see "MatlabPool.scheduler('longest')")
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitCost,double(cost),...
+                fun,uint64(nof_out),varargin{:});
+        end
+        
         function result = wait(jobid)
             result = MatlabPoolMEX(MatlabPool.cmd_wait,uint64(jobid));
         end
@@ -41,6 +108,10 @@ classdef MatlabPool < handle
             status = MatlabPoolMEX(MatlabPool.cmd_statusWorker);
         end
         
+        function status = statusPool()
+            status = MatlabPoolMEX(MatlabPool.cmd_statusPool);
+        end
+        
         function result = eval(fun)
             result = MatlabPoolMEX(MatlabPool.cmd_eval,fun);
             if ~isempty(result.errorBuf)
@@ -59,6 +130,359 @@ classdef MatlabPool < handle
         function clear()
             MatlabPoolMEX(MatlabPool.cmd_clear);
         end
+
+        function sink = createSink(class_name,dims)
+            % output array in shared memory, e.g.
+            % createSink('uint8',[height,width])
+            sink = MatlabPoolMEX(MatlabPool.cmd_createSink,class_name,uint64(dims));
+        end
+
+        function jobid = submitSink(sink,offset,slice_size,fun,varargin)
+            % the first return value of "fun" is written into the
+            % slice of the sink (offset is zero based)
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitSink,uint64(sink),...
+                uint64(offset),uint64(slice_size),fun,varargin{:});
+        end
+
+        function result = waitSink(sink)
+            result = MatlabPoolMEX(MatlabPool.cmd_waitSink,uint64(sink));
+        end
+
+        function gather = createGather(class_name,dims,offset,slice_size)
+            % preallocated output array, one row of "offset" (zero
+            % based) and "slice_size" for each slot
+            gather = MatlabPoolMEX(MatlabPool.cmd_createGather,class_name,...
+                uint64(dims),uint64(offset),uint64(slice_size));
+        end
+
+        function jobid = submitGather(gather,slot,fun,varargin)
+            % the first return value of "fun" is copied into the slot
+            % as soon as the job is finished
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitGather,uint64(gather),...
+                uint64(slot),fun,varargin{:});
+        end
+
+        function result = waitGather(gather)
+            result = MatlabPoolMEX(MatlabPool.cmd_waitGather,uint64(gather));
+        end
+
+        function argumentCache(threshold,capacity)
+            % arguments with at least "threshold" bytes are sent only
+            % once to each worker, "capacity" is the cache size per
+            % worker in bytes (zero disables the cache)
+            MatlabPoolMEX(MatlabPool.cmd_argumentCache,uint64(threshold),...
+                uint64(capacity));
+        end
+
+        function memoize(capacity,directory)
+            % memoization of job results, "capacity" of the memory
+            % cache in bytes and "directory" of the disk cache (the
+            % disk cache survives restarts). Zero capacity and no
+            % directory disable the memoization
+            if nargin < 2
+                directory = '';
+            end
+            MatlabPoolMEX(MatlabPool.cmd_memoize,uint64(capacity),char(directory));
+        end
+
+        function invalidateMemo(fun)
+            % remove the memoized results of a function (all results
+            % if no function is given)
+            if nargin < 1
+                fun = '';
+            end
+            MatlabPoolMEX(MatlabPool.cmd_invalidateMemo,char(fun));
+        end
+
+        function coalesce(flag)
+            % identical jobs (function and arguments) which are submitted
+            % while the first one is queued or running share its result
+            MatlabPoolMEX(MatlabPool.cmd_coalesce,logical(flag));
+        end
+
+        function batching(batch_size,window)
+            % up to "batch_size" queued jobs of the same function are
+            % evaluated by a single call of a worker, the pool waits up
+            % to "window" seconds for more jobs (batch_size <= 1
+            % disables the batching)
+            if nargin < 2
+                window = 0;
+            end
+            MatlabPoolMEX(MatlabPool.cmd_batching,uint64(batch_size),double(window));
+        end
+
+        function scheduler(name)
+            % assignment of the queued jobs to the workers:
+            %   'central'  : one queue for all workers (default)
+            %   'stealing' : one queue per worker, idle workers steal
+            %                jobs from the other queues
+            %   'longest'  : one queue ordered by the expected runtime
+            %                of the jobs (runtime history of their
+            %                function or the hint of "submitCost"),
+            %                the longest job first
+            MatlabPoolMEX(MatlabPool.cmd_scheduler,MatlabPool.scheduler_type(name));
+        end
+
+        function speculation(factor)
+            % only for idempotent jobs: if the queue is empty, a copy of
+            % a job, which runs longer than "factor" times the median
+            % runtime of its function, is evaluated by an idle worker,
+            % the first finished copy provides the results (factor = 0
+            % disables the speculation)
+            MatlabPoolMEX(MatlabPool.cmd_speculation,double(factor));
+        end
+
+        function autoscale(min_size,max_size,queue_depth,queue_wait,sustain,idle_timeout)
+            % the pool grows (up to "max_size" workers) if more than
+            % "queue_depth" jobs per worker are queued or the oldest job
+            % waits longer than "queue_wait" seconds, for at least 
+            % "sustain" seconds. The pool shrinks by one worker (down to
+            % "min_size") after "idle_timeout" seconds without queued 
+            % jobs. A "min_size" of zero disables the autoscaler
+            if nargin < 2
+                max_size = min_size;
+            end
+            if nargin < 3
+                queue_depth = 4;
+            end
+            if nargin < 4
+                queue_wait = 1;
+            end
+            if nargin < 5
+                sustain = 2;
+            end
+            if nargin < 6
+                idle_timeout = 60;
+            end
+            MatlabPoolMEX(MatlabPool.cmd_autoscale,uint64(min_size),...
+                uint64(max_size),uint64(queue_depth),double(queue_wait),...
+                double(sustain),double(idle_timeout));
+        end
+
+        function recycling(max_jobs,max_memory)
+            % replace the engine of a worker after "max_jobs" jobs or if
+            % it uses more than "max_memory" bytes (zero disables the 
+            % limit), the new engine is started first. A worker with 
+            % resident results, distributed data or actors is not 
+            % replaced until they are released
+            if nargin < 2
+                max_memory = 0;
+            end
+            MatlabPoolMEX(MatlabPool.cmd_recycling,uint64(max_jobs),...
+                uint64(max_memory));
+        end
+
+        function pinCpus(enable,cpus_per_worker,numa_spread)
+            % bind every worker to its own CPUs and limit its
+            % computational threads ("maxNumCompThreads") accordingly, 
+            % "cpus_per_worker" equal zero divides the CPUs evenly, the
+            % layout is shown by "statusWorker"
+            if nargin < 2
+                cpus_per_worker = 0;
+            end
+            if nargin < 3
+                numa_spread = false;
+            end
+            MatlabPoolMEX(MatlabPool.cmd_cpuPinning,logical(enable),...
+                uint64(cpus_per_worker),logical(numa_spread));
+        end
+
+        function id = addLane(name,reserved,max_share)
+            % latency lane: "reserved" workers are kept for the jobs of
+            % the lane (lent to other lanes while the lane has no
+            % queued jobs), the lane uses at most "max_share" of the
+            % workers. The jobs of "submit" belong to the lane
+            % 'default', an existing lane gets the new settings
+            if nargin < 3
+                max_share = 1;
+            end
+            id = MatlabPoolMEX(MatlabPool.cmd_addLane,name,...
+                uint64(reserved),double(max_share));
+        end
+
+        function jobid = submitLane(lane,fun,nof_out,varargin)
+            % like "submit", the job is queued in the lane "lane"
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitLane,uint64(lane),...
+                fun,uint64(nof_out),varargin{:});
+        end
+
+        function status = statusLanes()
+            % queue depth, running jobs and wait times (in seconds) of
+            % the lanes
+            status = MatlabPoolMEX(MatlabPool.cmd_statusLanes);
+        end
+
+        function id = registerTemplate(fun,nof_out,varargin)
+            % the fixed (trailing) arguments "varargin" are sent only
+            % once to each worker
+            id = MatlabPoolMEX(MatlabPool.cmd_registerTemplate,fun,...
+                uint64(nof_out),varargin{:});
+        end
+
+        function jobid = submitTemplate(id,varargin)
+            % evaluates fun(varargin{:},fixed{:})
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitTemplate,uint64(id),varargin{:});
+        end
+
+        function unregisterTemplate(id)
+            MatlabPoolMEX(MatlabPool.cmd_unregisterTemplate,uint64(id));
+        end
+
+        function id = broadcast(fun,nof_out,varargin)
+            % evaluates the function once on every worker, each worker
+            % starts the job as soon as it is free
+            id = MatlabPoolMEX(MatlabPool.cmd_broadcast,fun,uint64(nof_out),varargin{:});
+        end
+
+        function result = waitBroadcast(id)
+            % cell array with one result struct (see wait) per worker
+            result = MatlabPoolMEX(MatlabPool.cmd_waitBroadcast,uint64(id));
+        end
+
+        function initEval(cmd)
+            % the command is evaluated by the current workers and by
+            % every new worker before its first job
+            MatlabPool.check_init(MatlabPoolMEX(MatlabPool.cmd_initEval,cmd));
+        end
+
+        function initFeval(fun,nof_out,varargin)
+            % warm-up call, like initEval
+            MatlabPool.check_init(MatlabPoolMEX(MatlabPool.cmd_initFeval,...
+                fun,uint64(nof_out),varargin{:}));
+        end
+
+        function clearInit()
+            % new workers start without initialization
+            MatlabPoolMEX(MatlabPool.cmd_clearInit);
+        end
+
+        function jobid = submitAfter(after,fun,nof_out,varargin)
+            % the job starts after the jobs "after" and the jobs of the
+            % placeholders (see output) are finished, e.g.
+            %   id1 = MatlabPool.submit('magic',1,4);
+            %   id2 = MatlabPool.submitAfter([],'inv',1,MatlabPool.output(id1));
+            % A failed or canceled dependency fails the job
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitAfter,uint64(after),...
+                fun,uint64(nof_out),varargin{:});
+        end
+
+        function ref = output(jobid,k)
+            % placeholder for the k-th return value of a job
+            if nargin < 2
+                k = 1;
+            end
+            ref = struct('MatlabPoolOutput',uint64([jobid k]));
+        end
+
+        function ref = submitResident(fun,nof_out,varargin)
+            % like submit, but the return values stay on the worker,
+            % wait returns only their size, class and bytes. Jobs get
+            % the values with a placeholder (see output) and run on
+            % the same worker, e.g.
+            %   ref = MatlabPool.submitResident('rand',1,1e4);
+            %   id = MatlabPool.submitAfter([],'sum',1,MatlabPool.output(ref));
+            ref = MatlabPoolMEX(MatlabPool.cmd_submitResident,fun,uint64(nof_out),varargin{:});
+        end
+
+        function result = fetch(ref)
+            % cell array of the return values of a worker-resident
+            % result
+            result = MatlabPoolMEX(MatlabPool.cmd_fetchResult,uint64(ref));
+        end
+
+        function free(ref)
+            % remove the return values of a worker-resident result
+            MatlabPoolMEX(MatlabPool.cmd_freeResult,uint64(ref));
+        end
+
+        function jobid = mapReduce(fun,reduceFun,inputs)
+            % evaluate "fun" for every cell of "inputs" (a cell holds an
+            % argument or a cell array of arguments) and combine the
+            % return values pairwise by "reduceFun" on the workers, e.g.
+            %   id = MatlabPool.mapReduce('sum',@plus,{1:10,11:20});
+            % wait returns only the reduced value, but the partial value
+            % of every worker except one passes through the client. The
+            % values are not combined in the order of "inputs", so 
+            % "reduceFun" must be associative and commutative. An 
+            % anonymous "reduceFun" must not capture variables
+            if isa(reduceFun,'function_handle')
+                reduceFun = func2str(reduceFun);
+            end
+            jobid = MatlabPoolMEX(MatlabPool.cmd_mapReduce,fun,reduceFun,inputs);
+        end
+
+        function d = distribute(data,dim)
+            % partition a numeric array along the dimension "dim" into
+            % one block per worker, every block stays on its worker
+            d = MatlabPoolMEX(MatlabPool.cmd_distribute,data,uint64(dim));
+        end
+
+        function id = spmdCall(d,fun,nof_out,varargin)
+            % evaluate fun(block,varargin{:}) for every block of a 
+            % distributed array on the worker of the block, the results
+            % are returned by waitBroadcast (in the order of the blocks)
+            id = MatlabPoolMEX(MatlabPool.cmd_spmd,uint64(d),fun,uint64(nof_out),varargin{:});
+        end
+
+        function jobid = spmdReduce(d,fun,reduceFun,varargin)
+            % like spmdCall, but the results are combined by "reduceFun"
+            % (see mapReduce: associative and commutative, the partial
+            % value of every worker except one passes through the 
+            % client)
+            if isa(reduceFun,'function_handle')
+                reduceFun = func2str(reduceFun);
+            end
+            jobid = MatlabPoolMEX(MatlabPool.cmd_spmdReduce,uint64(d),fun,reduceFun,varargin{:});
+        end
+
+        function freeDistributed(d)
+            MatlabPoolMEX(MatlabPool.cmd_freeDistributed,uint64(d));
+        end
+
+        function actor = createActor(fun,varargin)
+            % construct an object on a worker, e.g.
+            %   actor = MatlabPool.createActor('struct','n',0);
+            % the function waits for the constructor
+            actor = MatlabPoolMEX(MatlabPool.cmd_createActor,fun,varargin{:});
+        end
+
+        function jobid = callActor(actor,method,nof_out,varargin)
+            % evaluate a method of the object on its worker, the calls
+            % of an actor are evaluated in order. A method of a value
+            % object returns the new object first, e.g.
+            %   function [s,n] = step(s), s.n = s.n + 1; n = s.n; end
+            jobid = MatlabPoolMEX(MatlabPool.cmd_callActor,uint64(actor),...
+                method,uint64(nof_out),varargin{:});
+        end
+
+        function obj = fetchActor(actor)
+            % copy of the object
+            obj = MatlabPoolMEX(MatlabPool.cmd_fetchActor,uint64(actor));
+        end
+
+        function destroyActor(actor)
+            MatlabPoolMEX(MatlabPool.cmd_destroyActor,uint64(actor));
+        end
+
+        function jobid = submitQuiet(fun,nof_out,varargin)
+            % like submit, but the output of the job is not captured
+            jobid = MatlabPoolMEX(MatlabPool.cmd_submitQuiet,fun,uint64(nof_out),varargin{:});
+        end
+
+        function str = readOutput(jobid,error_msg)
+            % new output of a job since the last call, also for 
+            % running jobs (error_msg = true for the error messages)
+            if nargin < 2
+                error_msg = false;
+            end
+            str = MatlabPoolMEX(MatlabPool.cmd_readOutput,uint64(jobid),logical(error_msg));
+        end
+
+        function outputLimit(limit)
+            % maximal number of captured characters of the output and
+            % error messages of a single job
+            MatlabPoolMEX(MatlabPool.cmd_outputLimit,uint64(limit));
+        end
         
         function resize(val)
             val = uint32(val);
@@ -71,4 +495,28 @@ classdef MatlabPool < handle
         end
         
     end
-end
\ No newline at end of file
+
+    methods(Static, Access = {?MatlabPoolHandle})
+
+        function val = scheduler_type(name)
+            names = {'central','stealing','longest'};
+            name = validatestring(name,names);
+            val = uint8(find(strcmp(name,names))-1);
+        end
+
+    end
+
+    methods(Static, Access = private)
+
+        function check_init(id)
+            % wait for the initialization of the current workers
+            result = MatlabPool.waitBroadcast(id);
+            for i = 1:numel(result)
+                if ~isempty(result{i}.errorBuf)
+                    error('MatlabPool:InitError',result{i}.errorBuf)
+                end
+            end
+        end
+
+    end
+end
@@ -0,0 +1,121 @@
+classdef MatlabPoolHandle < handle
+    % handle of a named pool (see "MatlabPool.pool"), the methods work
+    % like the static methods of "MatlabPool" on this pool
+
+    properties(SetAccess = private)
+        name
+        options
+    end
+
+    methods
+
+        function obj = MatlabPoolHandle(name,options)
+            assert(~isempty(name),'MatlabPool:InvalidName',...
+                'the default pool has no handle')
+            obj.name = char(name);
+            obj.options = options;
+        end
+
+        function jobid = submit(obj,fun,nof_out,varargin)
+            jobid = obj.call(MatlabPool.cmd_submit,fun,uint64(nof_out),varargin{:});
+        end
+
+        function result = wait(obj,jobid)
+            result = obj.call(MatlabPool.cmd_wait,uint64(jobid));
+        end
+
+        function cancel(obj,jobid)
+            obj.call(MatlabPool.cmd_cancel,uint64(jobid));
+        end
+
+        function clear(obj)
+            obj.call(MatlabPool.cmd_clear);
+        end
+
+        function status = statusJobs(obj)
+            status = obj.call(MatlabPool.cmd_statusJobs);
+        end
+
+        function status = statusWorker(obj)
+            status = obj.call(MatlabPool.cmd_statusWorker);
+        end
+
+        function val = size(obj)
+            val = obj.call(MatlabPool.cmd_size);
+        end
+
+        function resize(obj,val)
+            % a size of zero removes the pool
+            val = uint32(val);
+            if val == uint32(0)
+                obj.close();
+            else
+                obj.call(MatlabPool.cmd_resize,val,obj.options{:});
+            end
+        end
+
+        function scheduler(obj,name)
+            % see "MatlabPool.scheduler"
+            obj.call(MatlabPool.cmd_scheduler,MatlabPool.scheduler_type(name));
+        end
+
+        function autoscale(obj,min_size,max_size,queue_depth,queue_wait,sustain,idle_timeout)
+            % see "MatlabPool.autoscale", the new workers get the options
+            % of the handle
+            if nargin < 3
+                max_size = min_size;
+            end
+            if nargin < 4
+                queue_depth = 4;
+            end
+            if nargin < 5
+                queue_wait = 1;
+            end
+            if nargin < 6
+                sustain = 2;
+            end
+            if nargin < 7
+                idle_timeout = 60;
+            end
+            obj.call(MatlabPool.cmd_autoscale,uint64(min_size),...
+                uint64(max_size),uint64(queue_depth),double(queue_wait),...
+                double(sustain),double(idle_timeout));
+        end
+
+        function recycling(obj,max_jobs,max_memory)
+            % see "MatlabPool.recycling"
+            if nargin < 3
+                max_memory = 0;
+            end
+            obj.call(MatlabPool.cmd_recycling,uint64(max_jobs),uint64(max_memory));
+        end
+
+        function pinCpus(obj,enable,cpus_per_worker,numa_spread)
+            % see "MatlabPool.pinCpus"
+            if nargin < 3
+                cpus_per_worker = 0;
+            end
+            if nargin < 4
+                numa_spread = false;
+            end
+            obj.call(MatlabPool.cmd_cpuPinning,logical(enable),...
+                uint64(cpus_per_worker),logical(numa_spread));
+        end
+
+        function close(obj)
+            % remove the pool, the handle can create it again with
+            % "resize"
+            MatlabPoolMEX(MatlabPool.cmd_closePool,obj.name);
+        end
+
+    end
+
+    methods(Access = private)
+
+        function varargout = call(obj,cmd,varargin)
+            [varargout{1:nargout}] = MatlabPoolMEX(MatlabPool.cmd_onPool,...
+                obj.name,cmd,varargin{:});
+        end
+
+    end
+end
@@ -19,6 +19,26 @@ classdef MatlabPoolTest < matlab.unittest.TestCase
             assert(all(structfun(@(x)length(x),status) == 0),...
                    'there are jobs in the pool')
         end
+
+        function ok = wait_size(n)
+            for i = 1:600
+                if MatlabPool.size() == n
+                    break
+                end
+                pause(0.1)
+            end
+            ok = MatlabPool.size() == n;
+        end
+
+        function burst(k,t)
+            % "k" jobs per worker, the last ones wait in the queue
+            for i = k*MatlabPool.size():-1:1
+                id(i) = MatlabPool.submit('pause',0,t);
+            end
+            for i = 1:numel(id)
+                MatlabPool.wait(id(i));
+            end
+        end
     end
     
     methods (Test)
@@ -171,6 +191,232 @@ classdef MatlabPoolTest < matlab.unittest.TestCase
             MatlabPoolTest.check_is_empty()
         end
 
+        function test_workStealing(~)
+            MatlabPool.clear();
+            MatlabPool.scheduler('stealing');
+            cleanup = onCleanup(@()MatlabPool.scheduler('central'));
+            for i = MatlabPoolTest.N:-1:1
+                id(i) = MatlabPool.submit('sqrt',1,i);
+            end
+            for i = MatlabPoolTest.N:-1:1
+                result = MatlabPool.wait(id(i));
+                assert(abs(result.result-sqrt(i)) < eps)
+            end
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_longestFirst(~)
+            MatlabPool.clear();
+            MatlabPool.scheduler('longest');
+            cleanup = onCleanup(@()MatlabPool.scheduler('central'));
+            for i = MatlabPool.size():-1:1
+                blocker(i) = MatlabPool.submit('pause',0,0.5);
+            end
+            for i = 1:MatlabPoolTest.N
+                id(i) = MatlabPool.submitCost(i,'sqrt',1,i);
+            end
+            % queued jobs in the order of their cost hints
+            status = MatlabPool.statusJobs();
+            queued = status.JobID(status.Status == 0 & ismember(status.JobID,id));
+            assert(issorted(flip(queued)))
+            for i = 1:MatlabPoolTest.N
+                result = MatlabPool.wait(id(i));
+                assert(abs(result.result-sqrt(i)) < eps)
+            end
+            for i = 1:length(blocker)
+                MatlabPool.wait(blocker(i));
+            end
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_namedPools(~)
+            MatlabPool.clear();
+            compute = MatlabPool.pool('compute',1,{'-nojvm','-nosplash','-singleCompThread'});
+            cleanup = onCleanup(@()compute.close());
+            assert(compute.size() == 1)
+            compute.resize(2);
+            assert(compute.size() == 2)
+            assert(MatlabPool.size() ~= 0)
+            for i = MatlabPoolTest.N:-1:1
+                id(i) = compute.submit('sqrt',1,i);
+            end
+            % the job ids belong to the named pool
+            thrown = false;
+            try
+                MatlabPool.wait(id(1));
+            catch e
+                thrown = strcmp(e.identifier,'MatlabPoolMEX:JobNotExists');
+            end
+            assert(thrown,'no error thrown')
+            for i = MatlabPoolTest.N:-1:1
+                result = compute.wait(id(i));
+                assert(abs(result.result-sqrt(i)) < eps)
+            end
+            compute.close();
+            assert(compute.size() == 0)
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_lanes(~)
+            MatlabPool.clear();
+            lane = MatlabPool.addLane('interactive',1,0.5);
+            assert(lane == MatlabPool.addLane('interactive',1,0.5))
+            for i = 2*MatlabPool.size():-1:1
+                batch(i) = MatlabPool.submit('pause',0,0.5);
+            end
+            for i = MatlabPoolTest.N:-1:1
+                id(i) = MatlabPool.submitLane(lane,'sqrt',1,i);
+            end
+            for i = MatlabPoolTest.N:-1:1
+                result = MatlabPool.wait(id(i));
+                assert(abs(result.result-sqrt(i)) < eps)
+            end
+            status = MatlabPool.statusLanes();
+            assert(any(strcmp(status.Name,'interactive')))
+            assert(status.Started(lane+1) >= MatlabPoolTest.N)
+            for i = 1:length(batch)
+                MatlabPool.wait(batch(i));
+            end
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_speculation(~)
+            MatlabPool.clear();
+            MatlabPool.speculation(2);
+            cleanup = onCleanup(@()MatlabPool.speculation(0));
+            for i = MatlabPoolTest.N:-1:1
+                id(i) = MatlabPool.submit('pause',0,0.05);
+            end
+            for i = MatlabPoolTest.N:-1:1
+                MatlabPool.wait(id(i));
+            end
+            status = MatlabPool.statusPool();
+            MatlabPool.wait(MatlabPool.submit('pause',0,1));
+            status2 = MatlabPool.statusPool();
+            assert(MatlabPool.size() < 2 || ...
+                status2.SpeculativeCopies > status.SpeculativeCopies)
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_autoscale(~)
+            MatlabPool.clear();
+            n = MatlabPool.size();
+            cleanup = onCleanup(@()MatlabPool.autoscale(0));
+            MatlabPool.autoscale(n+1);
+            for i = 1:600
+                if MatlabPool.size() == n+1
+                    break
+                end
+                pause(0.1)
+            end
+            assert(MatlabPool.size() == n+1)
+            MatlabPool.autoscale(n);
+            for i = 1:600
+                if MatlabPool.size() == n
+                    break
+                end
+                pause(0.1)
+            end
+            assert(MatlabPool.size() == n)
+            status = MatlabPool.statusPool();
+            assert(status.ScaleUps > 0 && status.ScaleDowns > 0)
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_autoscaleTriggers(~)
+            MatlabPool.clear();
+            n = MatlabPool.size();
+            cleanup = onCleanup(@()MatlabPool.autoscale(0));
+
+            % two short overloads do not add up to "sustain"
+            status = MatlabPool.statusPool();
+            MatlabPool.autoscale(n,n+1,1,1e6,2.5,1e6);
+            MatlabPoolTest.burst(5,0.5);
+            pause(1)
+            MatlabPoolTest.burst(5,0.5);
+            status2 = MatlabPool.statusPool();
+            assert(status2.ScaleUps == status.ScaleUps && MatlabPool.size() == n)
+
+            % queue depth
+            MatlabPool.autoscale(n,n+1,1,1e6,0.5,1e6);
+            MatlabPoolTest.burst(6,1);
+            assert(MatlabPoolTest.wait_size(n+1))
+
+            % idle timeout, the worker of a block is kept
+            MatlabPool.autoscale(n,n+1,1,1e6,0.5,1);
+            d = MatlabPool.distribute(zeros(1,4*(n+1)),2);
+            pause(4)
+            assert(MatlabPool.size() == n+1)
+            MatlabPool.freeDistributed(d);
+            assert(MatlabPoolTest.wait_size(n))
+
+            % queue wait
+            MatlabPool.autoscale(n,n+1,1000,0.5,0.5,1e6);
+            MatlabPoolTest.burst(3,2);
+            assert(MatlabPoolTest.wait_size(n+1))
+            MatlabPool.autoscale(0);
+            MatlabPool.resize(n);
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_pinCpus(~)
+            MatlabPool.clear();
+            MatlabPool.pinCpus(true);
+            cleanup = onCleanup(@()MatlabPool.pinCpus(false));
+            status = MatlabPool.statusWorker();
+            assert(all(isfield(status,{'Pid','Cpus','Node'})))
+            assert(numel(status.Cpus) == MatlabPool.size())
+            cpus = [status.Cpus{:}];
+            assert(numel(unique(cpus)) == numel(cpus))
+            MatlabPool.wait(MatlabPool.submit('maxNumCompThreads',1));
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_recycling(~)
+            MatlabPool.clear();
+            n = MatlabPool.size();
+            status = MatlabPool.statusPool();
+            MatlabPool.recycling(2);
+            cleanup = onCleanup(@()MatlabPool.recycling(0));
+            for i = MatlabPoolTest.N:-1:1
+                id(i) = MatlabPool.submit('pause',0,0.05);
+            end
+            for i = MatlabPoolTest.N:-1:1
+                MatlabPool.wait(id(i));
+            end
+            for i = 1:600
+                status2 = MatlabPool.statusPool();
+                if status2.RecycledEngines > status.RecycledEngines
+                    break
+                end
+                pause(0.1)
+            end
+            assert(status2.RecycledEngines > status.RecycledEngines)
+            assert(MatlabPool.size() == n)
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_recyclingActor(~)
+            % the worker of an actor keeps its engine
+            MatlabPool.clear();
+            actor = MatlabPool.createActor('containers.Map');
+            MatlabPool.recycling(1);
+            cleanup = onCleanup(@()MatlabPool.recycling(0));
+            for i = 1:MatlabPoolTest.N
+                id(i) = MatlabPool.callActor(actor,'subsasgn',0,...
+                    substruct('()',{sprintf('k%d',i)}),i);
+                MatlabPool.wait(MatlabPool.submit('pause',0,0.01));
+            end
+            for i = 1:numel(id)
+                MatlabPool.wait(id(i));
+            end
+            pause(1)
+            result = MatlabPool.wait(MatlabPool.callActor(actor,'length',1));
+            assert(result.result == MatlabPoolTest.N)
+            MatlabPool.destroyActor(actor);
+            MatlabPoolTest.check_is_empty()
+        end
+
         function test_jobStatus(~)
             MatlabPool.clear();
             for i = MatlabPoolTest.N:-1:1
@@ -211,6 +457,181 @@ classdef MatlabPoolTest < matlab.unittest.TestCase
             MatlabPoolTest.check_is_empty()
         end
 
+        function test_sink(~)
+            MatlabPool.clear();
+            A = reshape(1:24,4,6);
+            USlice = fractal.UniformSlices(size(A),[2 3]);
+            [offset,slice_size] = USlice.getSlicesRegion();
+            s = USlice.getSlices(A);
+            sink = MatlabPool.createSink('double',size(A));
+            for i = 1:numel(s)
+                MatlabPool.submitSink(sink,offset(i,:),slice_size(i,:),...
+                                      'double',s{i});
+            end
+            result = MatlabPool.waitSink(sink);
+            assert(isequal(result,A))
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_gather(~)
+            MatlabPool.clear();
+            A = reshape(1:24,4,6);
+            USlice = fractal.UniformSlices(size(A),[2 3]);
+            [offset,slice_size] = USlice.getSlicesRegion();
+            s = USlice.getSlices(A);
+            gather = MatlabPool.createGather('double',size(A),offset,slice_size);
+            for i = 1:numel(s)
+                MatlabPool.submitGather(gather,i,'double',s{i});
+            end
+            result = MatlabPool.waitGather(gather);
+            assert(isequal(result,A))
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_memoize(~)
+            MatlabPool.clear();
+            directory = tempname;
+            mkdir(directory);
+            cleanup = onCleanup(@()rmdir(directory,'s'));
+
+            % disk cache only
+            MatlabPool.memoize(0,directory);
+            status = MatlabPool.statusPool();
+            for i = 1:2
+                id = MatlabPool.submit('magic',1,4);
+                result = MatlabPool.wait(id);
+                assert(isequal(result.result,magic(4)))
+            end
+            status2 = MatlabPool.statusPool();
+            assert(status2.MemoHits == status.MemoHits + 1)
+            assert(status2.MemoMisses == status.MemoMisses + 1)
+
+            MatlabPool.invalidateMemo('magic');
+            id = MatlabPool.submit('magic',1,4);
+            MatlabPool.wait(id);
+            status3 = MatlabPool.statusPool();
+            assert(status3.MemoMisses == status2.MemoMisses + 1)
+
+            MatlabPool.invalidateMemo();
+            MatlabPool.memoize(0);
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_template(~)
+            MatlabPool.clear();
+            tmpl = MatlabPool.registerTemplate('plus',1,10);
+            for i = MatlabPoolTest.N:-1:1
+                id(i) = MatlabPool.submitTemplate(tmpl,i);
+            end
+            for i = MatlabPoolTest.N:-1:1
+                result = MatlabPool.wait(id(i));
+                assert(result.result == i + 10)
+            end
+            MatlabPool.unregisterTemplate(tmpl);
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_initProfile(~)
+            MatlabPool.clear();
+            MatlabPool.initEval('matlabpool_init = 42;');
+            n = MatlabPool.size();
+            MatlabPool.resize(n + 1);
+            result = MatlabPool.waitBroadcast(...
+                MatlabPool.broadcast('evalin',1,'base','matlabpool_init'));
+            assert(numel(result) == n + 1)
+            assert(all(cellfun(@(x)x.result,result) == 42))
+            MatlabPool.resize(n);
+            MatlabPool.clearInit();
+            MatlabPool.waitBroadcast(...
+                MatlabPool.broadcast('evalin',0,'base','clear matlabpool_init'));
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_jobGraph(~)
+            MatlabPool.clear();
+            id1 = MatlabPool.submit('magic',1,4);
+            id2 = MatlabPool.submitAfter([],'sum',1,MatlabPool.output(id1));
+            id3 = MatlabPool.submitAfter(id2,'max',1,MatlabPool.output(id2),[],2);
+            result = MatlabPool.wait(id3);
+            assert(result.result == 34)
+
+            id4 = MatlabPool.submit('error',0,'failed');
+            id5 = MatlabPool.submitAfter(id4,'pwd',1);
+            result = MatlabPool.wait(id5);
+            assert(~isempty(result.errorBuf))
+
+            for id = [id1 id2 id4]
+                MatlabPool.wait(id);
+            end
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_resident(~)
+            MatlabPool.clear();
+            ref = MatlabPool.submitResident('magic',1,4);
+            id = MatlabPool.submitAfter([],'sum',1,MatlabPool.output(ref),2);
+            result = MatlabPool.wait(id);
+            assert(isequal(result.result,sum(magic(4),2)))
+
+            info = MatlabPool.wait(ref);
+            assert(isequal(info.result.size,[4 4]))
+            assert(strcmp(info.result.class,'double'))
+            value = MatlabPool.fetch(ref);
+            assert(isequal(value{1},magic(4)))
+            MatlabPool.free(ref);
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_mapReduce(~)
+            MatlabPool.clear();
+            inputs = num2cell(1:MatlabPoolTest.N);
+            id = MatlabPool.mapReduce('sqrt',@plus,inputs);
+            result = MatlabPool.wait(id);
+            assert(abs(result.result - sum(sqrt(1:MatlabPoolTest.N))) < 1e-10)
+
+            id = MatlabPool.mapReduce('sqrt',@(a,b)max(a,b),inputs);
+            result = MatlabPool.wait(id);
+            assert(abs(result.result - sqrt(MatlabPoolTest.N)) < 1e-10)
+
+            id = MatlabPool.mapReduce('error',@plus,{'failed'});
+            result = MatlabPool.wait(id);
+            assert(~isempty(result.errorBuf))
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_distributed(~)
+            MatlabPool.clear();
+            A = reshape(1:60,6,10);
+            d = MatlabPool.distribute(A,2);
+            result = MatlabPool.waitBroadcast(MatlabPool.spmdCall(d,'size',1,2));
+            assert(sum(cellfun(@(x)x.result,result)) == 10)
+
+            result = MatlabPool.wait(MatlabPool.spmdReduce(d,'sum',@plus,'all'));
+            assert(result.result == sum(A(:)))
+
+            result = MatlabPool.wait(MatlabPool.spmdReduce(d,'max',@(a,b)max(a,b),[],'all'));
+            assert(result.result == max(A(:)))
+            MatlabPool.freeDistributed(d);
+            MatlabPoolTest.check_is_empty()
+        end
+
+        function test_actor(~)
+            MatlabPool.clear();
+            actor = MatlabPool.createActor('containers.Map');
+            for i = 1:MatlabPoolTest.N
+                id(i) = MatlabPool.callActor(actor,'subsasgn',0,...
+                    substruct('()',{sprintf('k%d',i)}),i);
+            end
+            id(end+1) = MatlabPool.callActor(actor,'length',1);
+            for i = 1:numel(id) - 1
+                MatlabPool.wait(id(i));
+            end
+            result = MatlabPool.wait(id(end));
+            assert(result.result == MatlabPoolTest.N)
+            MatlabPool.destroyActor(actor);
+            MatlabPoolTest.check_is_empty()
+        end
+
         function test_workerStatus(~)
             MatlabPool.clear();
             for i = MatlabPoolTest.N:-1:1
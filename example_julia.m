@@ -46,11 +46,26 @@ end
 t_parallel = toc;
 n_parallel = USlice.mergeSlices(n_parallel);
 
+%% with MatlabPool and shared output (no result transfer, no merge)
+tic
+[offset,slice_size] = USlice.getSlicesRegion();
+sink = MatlabPool.createSink('uint8',[heigth,width]);
+for i = length(Z):-1:1
+    MatlabPool.submitSink(sink,offset(i,:),slice_size(i,:),...
+                          'fractal.julia',Z(i),a,c,max_iter,max_val);
+end
+n_shared = MatlabPool.waitSink(sink);
+t_shared = toc;
+
 %% disp results
-ax = subplot(1,2,1);
+ax = subplot(1,3,1);
 fractal.plot(ax,n_single,max_iter)
 title(sprintf('without MatlabPool: %.2f sec',t_single))
 
-ax = subplot(1,2,2);
+ax = subplot(1,3,2);
 fractal.plot(ax,n_parallel,max_iter)
 title(sprintf('with MatlabPool: %.2f sec',t_parallel))
+
+ax = subplot(1,3,3);
+fractal.plot(ax,n_shared,max_iter)
+title(sprintf('with MatlabPool (shared output): %.2f sec',t_shared))
@@ -3,27 +3,27 @@
 namespace MatlabPool
 {
 
-    JobBase::ExecutionError::ExecutionError(std::shared_ptr<StringBuf> buffer)
+    JobBase::ExecutionError::ExecutionError(const StreamBuf &buffer)
     {
         std::ostringstream os;
         os << "an error has occurred during execution";
-        if (buffer)
+        if (!buffer.empty())
         {
             os << '\n'
-                << convertUTF16StringToASCIIString(buffer->str());
+                << convertUTF16StringToASCIIString(buffer.str());
         }
         msg = os.str();
     }
 
     JobBase::ExecutionError::ExecutionError(JobID id,
-        std::shared_ptr<StringBuf> buffer)
+        const StreamBuf &buffer)
     {
         std::ostringstream os;
         os << "an error has occurred during job execution (id: " << id << ")";
-        if (buffer)
+        if (!buffer.empty())
         {
             os << '\n'
-                << convertUTF16StringToASCIIString(buffer->str());
+                << convertUTF16StringToASCIIString(buffer.str());
         }
         msg = os.str();
     }
@@ -87,6 +87,12 @@ namespace MatlabPool
         return errorBuf;
     }
 
+    void JobBase::set_capture(bool output, bool error) noexcept
+    {
+        outputBuf.set_capture(output);
+        errorBuf.set_capture(error);
+    }
+
     matlab::data::StructArray JobBase::toStruct()
     {
         auto st = factory.createStructArray({ 1 },
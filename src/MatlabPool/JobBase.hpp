@@ -12,6 +12,7 @@
 namespace MatlabPool
 {
     using JobID = std::uint64_t;
+    using LaneID = std::uint64_t;
 
     // base class for job classes. Every object of this class gets
     // an unique id (JobID). This class also provides an error and
@@ -26,8 +27,8 @@ namespace MatlabPool
         class ExecutionError : public JobBaseException
         {
         public:
-            ExecutionError(std::shared_ptr<StringBuf> buffer);
-            ExecutionError(JobID id, std::shared_ptr<StringBuf> buffer);
+            ExecutionError(const StreamBuf &buffer);
+            ExecutionError(JobID id, const StreamBuf &buffer);
             const char *what() const noexcept override;
             const char *identifier() const noexcept override;
 
@@ -53,6 +54,10 @@ namespace MatlabPool
         StreamBuf &get_outBuf() noexcept;
         StreamBuf &get_errBuf() noexcept;
 
+        // disable the capture of the output or rather error messages,
+        // e.g. for jobs with a lot of unneeded output
+        void set_capture(bool output, bool error) noexcept;
+
         // store the members of this object in a matlab struct
         matlab::data::StructArray toStruct();
 
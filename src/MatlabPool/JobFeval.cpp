@@ -17,7 +17,9 @@ namespace MatlabPool
     JobFeval::JobFeval() noexcept
         : JobBase(),
         status(Status::Empty),
-        workerID(-1) {}
+        workerID(-1),
+        cost(0),
+        lane(0) {}
 
     JobFeval::JobFeval(std::u16string cmd, std::size_t nlhs,
         std::vector<matlab::data::Array> &&args)
@@ -25,7 +27,9 @@ namespace MatlabPool
         status(Status::Wait),
         nlhs(nlhs),
         args(std::move(args)),
-        workerID(-1) {}
+        workerID(-1),
+        cost(0),
+        lane(0) {}
 
     JobFeval::JobFeval(JobFeval &&other) noexcept : JobFeval()
     {
@@ -49,6 +53,8 @@ namespace MatlabPool
         swap(j1.args, j2.args);
         swap(j1.result, j2.result);
         swap(j1.workerID, j2.workerID);
+        swap(j1.cost, j2.cost);
+        swap(j1.lane, j2.lane);
     }
 
     std::size_t JobFeval::get_nlhs() const noexcept
@@ -72,6 +78,26 @@ namespace MatlabPool
         return workerID;
     }
 
+    void JobFeval::set_cost(double val) noexcept
+    {
+        cost = val;
+    }
+
+    double JobFeval::get_cost() const noexcept
+    {
+        return cost;
+    }
+
+    void JobFeval::set_lane(LaneID val) noexcept
+    {
+        lane = val;
+    }
+
+    LaneID JobFeval::get_lane() const noexcept
+    {
+        return lane;
+    }
+
     JobFeval::Status JobFeval::get_status() const noexcept
     {
         return status;
@@ -80,7 +106,7 @@ namespace MatlabPool
     const std::vector<matlab::data::Array> &JobFeval::peek_result() const
     {
         if (status == Status::Error)
-            throw ExecutionError(id, errorBuf.get());
+            throw ExecutionError(id, errorBuf);
         if (status != Status::Done)
             throw NoResults();
 
@@ -90,7 +116,7 @@ namespace MatlabPool
     std::vector<matlab::data::Array> JobFeval::pop_result()
     {
         if (status == Status::Error)
-            throw ExecutionError(id, errorBuf.get());
+            throw ExecutionError(id, errorBuf);
         if (status != Status::Done)
             throw NoResults();
 
@@ -68,6 +68,19 @@ namespace MatlabPool
 
         int get_workerID() const noexcept;
 
+        // expected runtime in seconds, the hint replaces the runtime
+        // model of the pool (see "Pool::Scheduler::LongestFirst"), 
+        // zero for no hint
+        void set_cost(double val) noexcept;
+
+        double get_cost() const noexcept;
+
+        // latency lane of the job (see "Pool::add_lane"), zero for the
+        // default lane
+        void set_lane(LaneID val) noexcept;
+
+        LaneID get_lane() const noexcept;
+
         Status get_status() const noexcept;
 
         // return a reference to the results of the job
@@ -95,6 +108,8 @@ namespace MatlabPool
 
     private:
         int workerID;
+        double cost;
+        LaneID lane;
     };
 
 } // namespace MatlabPool
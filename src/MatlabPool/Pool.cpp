@@ -27,4 +27,167 @@ namespace MatlabPool
         return "EmptyPool";
     }
 
+    const char *Pool::EmptyReduction::what() const noexcept
+    {
+        return "reduction without inputs";
+    }
+    const char *Pool::EmptyReduction::identifier() const noexcept
+    {
+        return "EmptyReduction";
+    }
+
+    Pool::SinkNotExists::SinkNotExists(SinkID id)
+    {
+        std::ostringstream os;
+        os << "output sink with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::SinkNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::SinkNotExists::identifier() const noexcept
+    {
+        return "SinkNotExists";
+    }
+
+    Pool::GatherNotExists::GatherNotExists(GatherID id)
+    {
+        std::ostringstream os;
+        os << "gather target with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::GatherNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::GatherNotExists::identifier() const noexcept
+    {
+        return "GatherNotExists";
+    }
+
+    Pool::TemplateNotExists::TemplateNotExists(TemplateID id)
+    {
+        std::ostringstream os;
+        os << "job template with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::TemplateNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::TemplateNotExists::identifier() const noexcept
+    {
+        return "TemplateNotExists";
+    }
+
+    Pool::BroadcastNotExists::BroadcastNotExists(BroadcastID id)
+    {
+        std::ostringstream os;
+        os << "broadcast with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::BroadcastNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::BroadcastNotExists::identifier() const noexcept
+    {
+        return "BroadcastNotExists";
+    }
+
+    Pool::ResultNotExists::ResultNotExists(JobID id)
+    {
+        std::ostringstream os;
+        os << "worker-resident result with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::ResultNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::ResultNotExists::identifier() const noexcept
+    {
+        return "ResultNotExists";
+    }
+
+    Pool::ActorNotExists::ActorNotExists(ActorID id)
+    {
+        std::ostringstream os;
+        os << "actor with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::ActorNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::ActorNotExists::identifier() const noexcept
+    {
+        return "ActorNotExists";
+    }
+
+    Pool::LaneNotExists::LaneNotExists(LaneID id)
+    {
+        std::ostringstream os;
+        os << "lane with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::LaneNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::LaneNotExists::identifier() const noexcept
+    {
+        return "LaneNotExists";
+    }
+
+    Pool::DistributedNotExists::DistributedNotExists(DistributedID id)
+    {
+        std::ostringstream os;
+        os << "distributed array with id=" << id << " does not exists";
+        msg = os.str();
+    }
+    const char *Pool::DistributedNotExists::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::DistributedNotExists::identifier() const noexcept
+    {
+        return "DistributedNotExists";
+    }
+
+    Pool::InitError::InitError(const std::u16string &fun, const std::string &error)
+    {
+        std::ostringstream os;
+        os << "initialization of a worker failed (" 
+            << convertUTF16StringToASCIIString(fun) << "):\n" << error;
+        msg = os.str();
+    }
+    const char *Pool::InitError::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *Pool::InitError::identifier() const noexcept
+    {
+        return "InitError";
+    }
+
+    const char *Pool::InvalidSlice::what() const noexcept
+    {
+        return "the slice does not fit into the output sink";
+    }
+    const char *Pool::InvalidSlice::identifier() const noexcept
+    {
+        return "InvalidSlice";
+    }
+
+    const char *Pool::InvalidDependency::what() const noexcept
+    {
+        return "the argument of the dependency does not exist";
+    }
+    const char *Pool::InvalidDependency::identifier() const noexcept
+    {
+        return "InvalidDependency";
+    }
+
 } // namespace MatlabPool
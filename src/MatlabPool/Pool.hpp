@@ -3,14 +3,63 @@
 
 #include "MatlabPool/JobFeval.hpp"
 #include "MatlabPool/JobEval.hpp"
+#include "MatlabPool/Utilities.hpp"
 
 namespace MatlabPool
 {
+    using SinkID = std::uint64_t;
+    using GatherID = std::uint64_t;
+    using TemplateID = std::uint64_t;
+    using BroadcastID = std::uint64_t;
+    using ActorID = std::uint64_t;
+    using DistributedID = std::uint64_t;
+
+    // dependency of a job on another job: the argument "arg" of the
+    // job is replaced by the return value "output" of the job "job".
+    // A dependency with "arg" = "none" only delays the job
+    struct JobDependency
+    {
+        static constexpr std::size_t none = std::size_t(-1);
+
+        JobID job;
+        std::size_t output;
+        std::size_t arg;
+    };
+
     // the abstract Pool class. E.g the shared library 
     // MatlabPoolLib contains a derived class
     class Pool
     {
     public:
+        // assignment of the queued jobs to the workers: a central 
+        // queue for all workers, a queue for each worker, where idle
+        // workers steal jobs from the other queues, or a central queue
+        // ordered by the expected runtime of the jobs (the longest job
+        // first, see "JobFeval::set_cost")
+        enum class Scheduler
+        {
+            Central,
+            WorkStealing,
+            LongestFirst
+        };
+
+        // settings of the autoscaler (see "set_autoscaling"). The 
+        // pool grows if more than "queueDepth" jobs per worker are 
+        // queued or the oldest queued job waits longer than 
+        // "queueWait" seconds, for at least "sustain" seconds. The pool
+        // shrinks by one worker if all workers were idle and no job
+        // was queued for "idleTimeout" seconds. The timers restart 
+        // after every resize.
+        struct Autoscaling
+        {
+            std::size_t minSize = 0;    // zero disables the autoscaler
+            std::size_t maxSize = 0;
+            std::size_t queueDepth = 4;
+            double queueWait = 1.0;
+            double sustain = 2.0;
+            double idleTimeout = 60.0;
+        };
+
         class PoolException : public Exception
         {
         };
@@ -33,6 +82,119 @@ namespace MatlabPool
             const char *identifier() const noexcept override;
         };
 
+        class EmptyReduction : public PoolException
+        {
+        public:
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+        };
+
+        class SinkNotExists : public PoolException
+        {
+        public:
+            SinkNotExists(SinkID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+
+        class GatherNotExists : public PoolException
+        {
+        public:
+            GatherNotExists(GatherID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+
+        class TemplateNotExists : public PoolException
+        {
+        public:
+            TemplateNotExists(TemplateID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+        class BroadcastNotExists : public PoolException
+        {
+        public:
+            BroadcastNotExists(BroadcastID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+        class ResultNotExists : public PoolException
+        {
+        public:
+            ResultNotExists(JobID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+        class ActorNotExists : public PoolException
+        {
+        public:
+            ActorNotExists(ActorID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+        class LaneNotExists : public PoolException
+        {
+        public:
+            LaneNotExists(LaneID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+        class DistributedNotExists : public PoolException
+        {
+        public:
+            DistributedNotExists(DistributedID id);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+        class InitError : public PoolException
+        {
+        public:
+            InitError(const std::u16string &fun, const std::string &error);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+
+        class InvalidSlice : public PoolException
+        {
+        public:
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+        };
+        class InvalidDependency : public PoolException
+        {
+        public:
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+        };
+
     protected:
         Pool() {}
 
@@ -49,8 +211,210 @@ namespace MatlabPool
         virtual void eval(JobEval &job) = 0;
         virtual matlab::data::StructArray get_job_status() = 0;
         virtual matlab::data::StructArray get_worker_status() = 0;
+        virtual matlab::data::StructArray get_pool_status() = 0;
         virtual void cancel(JobID jobID) = 0;
         virtual void clear() = 0;
+
+        // shared memory output sinks: the jobs of a sink write their
+        // first return value directly into a slice of the sink, so
+        // they should be submitted with nlhs = 0
+        virtual SinkID create_sink(matlab::data::ArrayType type,
+            const std::vector<std::size_t> &dims) = 0;
+        virtual JobID submit(JobFeval &&job, SinkID sink,
+            const Utilities::Slice &slice) = 0;
+        virtual matlab::data::Array wait_sink(SinkID sink) = 0;
+
+        // gather targets: the first return value of a job is copied
+        // into its slot of the preallocated output array as soon as
+        // the job is finished
+        virtual GatherID create_gather(matlab::data::Array output,
+            std::vector<Utilities::Slice> slices) = 0;
+        virtual JobID submit(JobFeval &&job, GatherID gather,
+            std::size_t slot) = 0;
+        virtual matlab::data::Array wait_gather(GatherID gather) = 0;
+
+        // content addressed argument cache: arguments with at least
+        // "threshold" bytes are sent only once to each worker, 
+        // "capacity" is the cache size per worker in bytes (zero 
+        // disables the cache)
+        virtual void set_argument_cache(std::size_t threshold,
+            std::size_t capacity) = 0;
+
+        // memoization of job results (only for jobs submitted without
+        // a sink or gather target): "capacity" of the memory tier in
+        // bytes and "directory" of the disk tier (empty for no disk 
+        // tier), the results of a function can be invalidated 
+        virtual void set_memoization(std::size_t capacity,
+            const std::u16string &directory) = 0;
+        virtual void invalidate_memoization(const std::u16string &fun) = 0;
+
+        // coalescing of identical jobs (only for jobs submitted 
+        // without a sink or gather target): a job with the same 
+        // function, nlhs and arguments as a job in the queue or in 
+        // progress shares the execution of that job
+        virtual void set_coalescing(bool val) = 0;
+
+        // batching of small jobs (only for jobs submitted without a
+        // sink or gather target): up to "size" queued jobs of the same
+        // function are evaluated by a single call of the worker, the
+        // pool waits up to "window" seconds for more jobs (before a 
+        // worker is reserved). A size of zero or one disables the 
+        // batching
+        virtual void set_batching(std::size_t size, double window) = 0;
+
+        // the default is "Scheduler::Central"
+        virtual void set_scheduler(Scheduler type) = 0;
+
+        // speculative re-execution of stragglers (only for idempotent
+        // jobs submitted without a sink or gather target, a template
+        // or dependencies): if the queue is empty, a copy of a job, 
+        // which runs longer than "factor" times the median runtime of
+        // its function, is evaluated by an idle worker. The first
+        // finished copy provides the results, the other one is 
+        // canceled. A factor of zero disables the speculation
+        virtual void set_speculation(double factor) = 0;
+
+        // the autoscaler starts and stops workers with "resize" and
+        // the engine options of the last resize (or the constructor)
+        virtual void set_autoscaling(const Autoscaling &val) = 0;
+
+        // replace the engine of a worker after "maxJobs" jobs or if 
+        // its resident memory exceeds "maxMemory" bytes (zero disables
+        // the limit). The new engine is started before the old one is
+        // retired, so the pool keeps its size. A worker, which keeps 
+        // results (e.g. "submit_resident"), data blocks or actors, is
+        // not replaced until they are released
+        virtual void set_recycling(std::size_t maxJobs, std::size_t maxMemory) = 0;
+
+        // bind every worker to a disjoint set of "cpusPerWorker" CPUs 
+        // (zero divides the CPUs evenly between the workers),
+        // "maxNumCompThreads" of the workers follows the size of the 
+        // sets. With "numaSpread" the workers are distributed over the
+        // NUMA nodes. The layout is rebuilt when the pool is resized,
+        // workers without a free set are not pinned. The layout is 
+        // reported by "get_worker_status"
+        virtual void set_cpu_pinning(bool enable, std::size_t cpusPerWorker,
+            bool numaSpread) = 0;
+
+        // latency lanes: the jobs of a lane (see "JobFeval::set_lane")
+        // are queued separately. "reserved" workers are kept for the
+        // jobs of the lane, but they are lent to other lanes while the
+        // queue of the lane is empty. The lane uses at most "maxShare"
+        // of the workers (at least the reserved workers). The jobs
+        // without a lane belong to the lane "default" (LaneID 0). A 
+        // call with the name of an existing lane changes its settings
+        virtual LaneID add_lane(std::u16string name, std::size_t reserved,
+            double maxShare) = 0;
+
+        // queue depth, running jobs and wait times of the lanes
+        virtual matlab::data::StructArray get_lane_status() = 0;
+
+        // maximal number of captured characters of the output and 
+        // error messages of a single job, further characters are 
+        // dropped (see "JobBase::set_capture" to disable the capture)
+        virtual void set_output_limit(std::size_t limit) = 0;
+
+        // new output (or rather error messages) of a job since the 
+        // last call, this works also for running jobs
+        virtual std::u16string read_output(JobID id, bool error) = 0;
+
+        // job templates: the function and the fixed (trailing) 
+        // arguments are registered once and the fixed arguments are
+        // sent only once to each worker, a job of a template contains
+        // only the varying (leading) arguments
+        virtual TemplateID register_template(std::u16string fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&fixedArgs) = 0;
+        virtual JobID submit(TemplateID id, std::vector<matlab::data::Array> &&args) = 0;
+        virtual void unregister_template(TemplateID id) = 0;
+
+        // broadcast: the function is evaluated once on every worker,
+        // each worker evaluates the job as soon as it is free (before
+        // the jobs of the queue). "wait_broadcast" returns the jobs
+        // in the order of the workers
+        virtual BroadcastID broadcast(std::u16string fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&args) = 0;
+        virtual std::vector<JobFeval> wait_broadcast(BroadcastID id) = 0;
+
+        // initialization profile: an ordered list of commands (eval in
+        // the base workspace) and warm-up function calls, which are
+        // evaluated by every new engine before it gets any job. A new
+        // step is evaluated by the current workers as a broadcast and
+        // is only added to the profile if it succeeds on all of them.
+        // The returned broadcast must be waited for with 
+        // "wait_broadcast" (e.g. to check for errors), its jobs are 
+        // kept until then or until "clear"
+        virtual BroadcastID add_init_eval(std::u16string cmd) = 0;
+        virtual BroadcastID add_init_feval(std::u16string fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&args) = 0;
+        virtual void clear_init() = 0;
+
+        // job graph: the job is queued after all jobs of "deps" are
+        // finished, their return values are passed as arguments (the
+        // placeholders in the arguments of "job" are replaced). The
+        // pool prefers the worker which holds the return values. If a
+        // dependency fails or is canceled, the job fails as well. The
+        // dependencies must be submitted before they are waited for
+        virtual JobID submit(JobFeval &&job, std::vector<JobDependency> &&deps) = 0;
+
+        // worker-resident results: the return values of the job stay
+        // on the worker, the job returns only a struct array with the
+        // fields "size", "class" and "bytes" (one element for each
+        // return value). The id of the job is the handle of the 
+        // values, other jobs get them with a dependency (see above)
+        // and are evaluated by the same worker. "fetch_result" copies
+        // the values to the client, "free_result" removes them
+        virtual JobID submit_resident(JobFeval &&job) = 0;
+        virtual std::vector<matlab::data::Array> fetch_result(JobID ref) = 0;
+        virtual void free_result(JobID ref) = 0;
+
+        // map-reduce: "fun" is evaluated for every argument list of
+        // "inputs" (one return value). The return values stay on the
+        // workers and are combined pairwise by "reduceFun" (two
+        // arguments, one return value), first on each worker and then
+        // across the workers. The engines have no channel between 
+        // each other, so the partial value of every worker except the
+        // one of the final reduction passes through the client once
+        // (see "PassedResults" of "get_pool_status"), the return values
+        // of "fun" do not. Only the reduced value is returned by the 
+        // job. The values are combined in the order of the workers and
+        // their slots, not in the order of "inputs", so "reduceFun" 
+        // must be associative and commutative. "reduceFun" is a name 
+        // or the text of an anonymous function without captured 
+        // variables, e.g. "@(a,b)max(a,b)"
+        virtual JobID map_reduce(std::u16string fun, std::u16string reduceFun,
+            std::vector<std::vector<matlab::data::Array>> &&inputs) = 0;
+
+        // distributed arrays: "data" (real numeric) is partitioned 
+        // along the dimension "dim" (zero based) into one block per
+        // worker, every block stays on its worker. "spmd" evaluates
+        // "fun(block, args...)" for every block on the worker of the 
+        // block (see "wait_broadcast"), "spmd_reduce" combines the 
+        // results pairwise by "reduceFun" (see "map_reduce"). Like 
+        // with "map_reduce", the partial value of every worker except
+        // the one of the final reduction passes through the client,
+        // not only the reduced value
+        virtual DistributedID distribute(matlab::data::Array data, std::size_t dim) = 0;
+        virtual BroadcastID spmd(DistributedID id, std::u16string fun,
+            std::size_t nlhs, std::vector<matlab::data::Array> &&args) = 0;
+        virtual JobID spmd_reduce(DistributedID id, std::u16string fun,
+            std::u16string reduceFun, std::vector<matlab::data::Array> &&args) = 0;
+        virtual void free_distributed(DistributedID id) = 0;
+
+        // stateful actors: "fun" constructs an object on a worker, 
+        // the methods of the object are evaluated by this worker in 
+        // the order of submission, as
+        //   [obj, out...] = method(obj, args...)   for value objects
+        //   [out...] = method(obj, args...)        for handle objects
+        // The object stays on the worker, "fetch_actor" returns a 
+        // copy. If the worker is removed, the object is constructed
+        // again on another worker. "create_actor" waits for the
+        // constructor
+        virtual ActorID create_actor(std::u16string fun,
+            std::vector<matlab::data::Array> &&args) = 0;
+        virtual JobID call_actor(ActorID id, std::u16string method,
+            std::size_t nlhs, std::vector<matlab::data::Array> &&args) = 0;
+        virtual matlab::data::Array fetch_actor(ActorID id) = 0;
+        virtual void destroy_actor(ActorID id) = 0;
     };
 } // namespace MatlabPool
 
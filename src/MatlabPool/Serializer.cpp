@@ -0,0 +1,417 @@
+#include "MatlabPool/Serializer.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <type_traits>
+
+namespace MatlabPool
+{
+    namespace
+    {
+        // calls "fun" with a null pointer to the C++ element type of
+        // an array type with fixed element size (numeric, complex,
+        // logical and char arrays)
+        template <typename FUN>
+        decltype(auto) visitElement(matlab::data::ArrayType type, FUN &&fun)
+        {
+            using matlab::data::ArrayType;
+            switch (type)
+            {
+            case ArrayType::LOGICAL:
+                return fun(static_cast<bool *>(nullptr));
+            case ArrayType::CHAR:
+                return fun(static_cast<char16_t *>(nullptr));
+            case ArrayType::COMPLEX_DOUBLE:
+                return fun(static_cast<std::complex<double> *>(nullptr));
+            case ArrayType::COMPLEX_SINGLE:
+                return fun(static_cast<std::complex<float> *>(nullptr));
+            case ArrayType::COMPLEX_INT8:
+                return fun(static_cast<std::complex<std::int8_t> *>(nullptr));
+            case ArrayType::COMPLEX_UINT8:
+                return fun(static_cast<std::complex<std::uint8_t> *>(nullptr));
+            case ArrayType::COMPLEX_INT16:
+                return fun(static_cast<std::complex<std::int16_t> *>(nullptr));
+            case ArrayType::COMPLEX_UINT16:
+                return fun(static_cast<std::complex<std::uint16_t> *>(nullptr));
+            case ArrayType::COMPLEX_INT32:
+                return fun(static_cast<std::complex<std::int32_t> *>(nullptr));
+            case ArrayType::COMPLEX_UINT32:
+                return fun(static_cast<std::complex<std::uint32_t> *>(nullptr));
+            case ArrayType::COMPLEX_INT64:
+                return fun(static_cast<std::complex<std::int64_t> *>(nullptr));
+            case ArrayType::COMPLEX_UINT64:
+                return fun(static_cast<std::complex<std::uint64_t> *>(nullptr));
+            default:
+                return Utilities::visitNumeric(type, std::forward<FUN>(fun));
+            }
+        }
+
+        template <typename T>
+        void writeElements(Serializer::Writer &writer, const matlab::data::Array &val)
+        {
+            // the iterators do not provide access to the raw memory,
+            // so the elements are copied into a small buffer
+            constexpr std::size_t buffer_size = 1024;
+            T buffer[buffer_size];
+            std::size_t n = 0;
+
+            const matlab::data::TypedArray<T> tmp(val);
+            for (const T &e : tmp)
+            {
+                buffer[n++] = e;
+                if (n == buffer_size)
+                {
+                    writer.write(buffer, sizeof(buffer));
+                    n = 0;
+                }
+            }
+            writer.write(buffer, n * sizeof(T));
+        }
+
+        template <typename T>
+        matlab::data::Array readElements(Serializer::Reader &reader,
+            matlab::data::ArrayDimensions dims)
+        {
+            constexpr std::size_t buffer_size = 1024;
+            T buffer[buffer_size];
+            std::size_t i = 0;
+            std::size_t n = 0;
+
+            matlab::data::ArrayFactory factory;
+            auto tmp = factory.createArray<T>(std::move(dims));
+            std::size_t remaining = tmp.getNumberOfElements();
+            for (T &e : tmp)
+            {
+                if (i == n)
+                {
+                    n = std::min(remaining, buffer_size);
+                    reader.read(buffer, n * sizeof(T));
+                    remaining -= n;
+                    i = 0;
+                }
+                e = buffer[i++];
+            }
+            return tmp;
+        }
+
+        void writeAscii(Serializer::Writer &writer, const std::string &val)
+        {
+            Serializer::write(writer, std::uint64_t(val.size()));
+            writer.write(val.data(), val.size());
+        }
+
+        std::string readAscii(Serializer::Reader &reader)
+        {
+            std::string val(Serializer::read_uint64(reader), '\0');
+            reader.read(&val[0], val.size());
+            return val;
+        }
+
+        inline std::uint64_t rotl(std::uint64_t x, int r) noexcept
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        inline std::uint64_t fmix(std::uint64_t k) noexcept
+        {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdULL;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ULL;
+            k ^= k >> 33;
+            return k;
+        }
+
+        constexpr std::uint64_t c1 = 0x87c37b91114253d5ULL;
+        constexpr std::uint64_t c2 = 0x4cf5ad432745937fULL;
+    } // namespace
+
+    const char *Serializer::InvalidData::what() const noexcept
+    {
+        return "invalid or incomplete serialized data";
+    }
+    const char *Serializer::InvalidData::identifier() const noexcept
+    {
+        return "InvalidSerializedData";
+    }
+
+    void Serializer::write(Writer &writer, const matlab::data::Array &val)
+    {
+        using matlab::data::ArrayType;
+
+        ArrayType type = val.getType();
+        auto dims = val.getDimensions();
+
+        // header
+        write(writer, std::uint64_t(type));
+        write(writer, std::uint64_t(dims.size()));
+        for (auto d : dims)
+            write(writer, std::uint64_t(d));
+
+        // data
+        switch (type)
+        {
+        case ArrayType::MATLAB_STRING:
+        {
+            const matlab::data::StringArray tmp(val);
+            for (const matlab::data::MATLABString &e : tmp)
+            {
+                write(writer, std::uint64_t(e.has_value()));
+                if (e.has_value())
+                    write(writer, *e);
+            }
+            break;
+        }
+        case ArrayType::CELL:
+        {
+            const matlab::data::CellArray tmp(val);
+            for (const matlab::data::Array &e : tmp)
+                write(writer, e);
+            break;
+        }
+        case ArrayType::STRUCT:
+        {
+            const matlab::data::StructArray tmp(val);
+            std::vector<std::string> names;
+            for (const auto &name : tmp.getFieldNames())
+                names.push_back(name);
+
+            write(writer, std::uint64_t(names.size()));
+            for (const auto &name : names)
+                writeAscii(writer, name);
+
+            for (const matlab::data::Struct &e : tmp)
+                for (const auto &name : names)
+                    write(writer, e[name]);
+            break;
+        }
+        default:
+            visitElement(type, [&](auto *p) {
+                using T = std::remove_pointer_t<decltype(p)>;
+                writeElements<T>(writer, val);
+            });
+        }
+    }
+
+    void Serializer::write(Writer &writer, const std::u16string &val)
+    {
+        write(writer, std::uint64_t(val.size()));
+        writer.write(val.data(), val.size() * sizeof(char16_t));
+    }
+
+    void Serializer::write(Writer &writer, std::uint64_t val)
+    {
+        writer.write(&val, sizeof(val));
+    }
+
+    matlab::data::Array Serializer::read_array(Reader &reader)
+    {
+        using matlab::data::ArrayType;
+
+        // header
+        std::uint64_t type_id = read_uint64(reader);
+        if (type_id > std::uint64_t(ArrayType::UNKNOWN))
+            throw InvalidData();
+        ArrayType type = ArrayType(type_id);
+
+        matlab::data::ArrayDimensions dims(read_uint64(reader));
+        for (auto &d : dims)
+            d = std::size_t(read_uint64(reader));
+
+        // data
+        matlab::data::ArrayFactory factory;
+        switch (type)
+        {
+        case ArrayType::MATLAB_STRING:
+        {
+            auto tmp = factory.createArray<matlab::data::MATLABString>(std::move(dims));
+            for (auto it = tmp.begin(); it != tmp.end(); ++it)
+            {
+                if (read_uint64(reader))
+                    *it = read_string(reader);
+                else
+                    *it = matlab::data::MATLABString();
+            }
+            return tmp;
+        }
+        case ArrayType::CELL:
+        {
+            auto tmp = factory.createCellArray(std::move(dims));
+            for (auto it = tmp.begin(); it != tmp.end(); ++it)
+                *it = read_array(reader);
+            return tmp;
+        }
+        case ArrayType::STRUCT:
+        {
+            std::vector<std::string> names(read_uint64(reader));
+            for (auto &name : names)
+                name = readAscii(reader);
+
+            auto tmp = factory.createStructArray(std::move(dims), names);
+            for (auto it = tmp.begin(); it != tmp.end(); ++it)
+                for (const auto &name : names)
+                    (*it)[name] = read_array(reader);
+            return tmp;
+        }
+        default:
+            return visitElement(type, [&](auto *p) {
+                using T = std::remove_pointer_t<decltype(p)>;
+                return readElements<T>(reader, std::move(dims));
+            });
+        }
+    }
+
+    std::u16string Serializer::read_string(Reader &reader)
+    {
+        std::u16string val(read_uint64(reader), u'\0');
+        reader.read(&val[0], val.size() * sizeof(char16_t));
+        return val;
+    }
+
+    std::uint64_t Serializer::read_uint64(Reader &reader)
+    {
+        std::uint64_t val;
+        reader.read(&val, sizeof(val));
+        return val;
+    }
+
+    std::size_t Serializer::get_bytes(const matlab::data::Array &val) noexcept
+    {
+        using matlab::data::ArrayType;
+        try
+        {
+            std::size_t n = 0;
+            switch (val.getType())
+            {
+            case ArrayType::MATLAB_STRING:
+            {
+                const matlab::data::StringArray tmp(val);
+                for (const matlab::data::MATLABString &e : tmp)
+                    if (e.has_value())
+                        n += e->size() * sizeof(char16_t);
+                return n;
+            }
+            case ArrayType::CELL:
+            {
+                const matlab::data::CellArray tmp(val);
+                for (const matlab::data::Array &e : tmp)
+                    n += get_bytes(e);
+                return n;
+            }
+            case ArrayType::STRUCT:
+            {
+                const matlab::data::StructArray tmp(val);
+                std::vector<std::string> names;
+                for (const auto &name : tmp.getFieldNames())
+                    names.push_back(name);
+                for (const matlab::data::Struct &e : tmp)
+                    for (const auto &name : names)
+                        n += get_bytes(e[name]);
+                return n;
+            }
+            default:
+                return visitElement(val.getType(), [&](auto *p) {
+                    return val.getNumberOfElements() * sizeof(*p);
+                });
+            }
+        }
+        catch (...)
+        {
+            return 0;
+        }
+    }
+
+    bool Digest::operator==(const Digest &other) const noexcept
+    {
+        return h1 == other.h1 && h2 == other.h2;
+    }
+
+    bool Digest::operator!=(const Digest &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    bool Digest::operator<(const Digest &other) const noexcept
+    {
+        return h1 < other.h1 || (h1 == other.h1 && h2 < other.h2);
+    }
+
+    std::string Digest::to_string() const
+    {
+        static constexpr const char hex[] = "0123456789abcdef";
+        std::string str(32, '0');
+        for (int i = 0; i < 16; i++)
+        {
+            str[15 - i] = hex[(h1 >> (4 * i)) & 0xF];
+            str[31 - i] = hex[(h2 >> (4 * i)) & 0xF];
+        }
+        return str;
+    }
+
+    Hasher::Hasher() noexcept
+        : h1(0x9368e53c2f6af274ULL),
+        h2(0x586dcd208f7cd3fdULL),
+        length(0),
+        tail(0),
+        n_tail(0)
+    {
+    }
+
+    void Hasher::write(const void *data, std::size_t n)
+    {
+        const unsigned char *ptr = static_cast<const unsigned char *>(data);
+        length += n;
+
+        // fill the remaining bytes of the last word
+        while (n_tail != 0 && n > 0)
+        {
+            tail |= std::uint64_t(*ptr++) << (8 * n_tail);
+            --n;
+            if (++n_tail == 8)
+            {
+                process(tail);
+                tail = 0;
+                n_tail = 0;
+            }
+        }
+
+        // full words
+        for (; n >= 8; n -= 8, ptr += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, ptr, 8);
+            process(word);
+        }
+
+        // remaining bytes
+        for (; n > 0; --n)
+            tail |= std::uint64_t(*ptr++) << (8 * n_tail++);
+    }
+
+    Digest Hasher::get_digest() const noexcept
+    {
+        Hasher tmp(*this);
+        if (tmp.n_tail != 0)
+            tmp.process(tmp.tail);
+        tmp.process(length);
+
+        std::uint64_t a = fmix(tmp.h1 + tmp.h2);
+        std::uint64_t b = fmix(tmp.h2 + a);
+        return Digest{ a, b };
+    }
+
+    void Hasher::process(std::uint64_t word) noexcept
+    {
+        std::uint64_t k1 = rotl(word * c1, 31) * c2;
+        h1 ^= k1;
+        h1 = rotl(h1, 27) + h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        std::uint64_t k2 = rotl(word * c2, 33) * c1;
+        h2 ^= k2;
+        h2 = rotl(h2, 31) + h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+} // namespace MatlabPool
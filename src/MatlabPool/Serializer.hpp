@@ -0,0 +1,104 @@
+#ifndef MATLABPOOL_SERIALIZER_HPP
+#define MATLABPOOL_SERIALIZER_HPP
+
+#include "MatlabPool/Utilities.hpp"
+
+#include "MatlabDataArray.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace MatlabPool
+{
+    // This class writes matlab arrays as a canonical byte stream,
+    // i.e. arrays with the same content (type, dimensions, values)
+    // generate the same byte stream. Supported are numeric, logical,
+    // char, string, cell and struct arrays. Other types (e.g. objects
+    // or sparse arrays) throw "Utilities::UnsupportedType".
+    class Serializer
+    {
+    public:
+        class SerializerException : public Exception
+        {
+        };
+        class InvalidData : public SerializerException
+        {
+        public:
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+        };
+
+    public:
+        // destination of the byte stream
+        class Writer
+        {
+        public:
+            virtual ~Writer() {}
+            virtual void write(const void *data, std::size_t n) = 0;
+        };
+
+        // source of the byte stream, throws "InvalidData" if the 
+        // stream ends
+        class Reader
+        {
+        public:
+            virtual ~Reader() {}
+            virtual void read(void *data, std::size_t n) = 0;
+        };
+
+    public:
+        Serializer() = delete;
+
+        static void write(Writer &writer, const matlab::data::Array &val);
+        static void write(Writer &writer, const std::u16string &val);
+        static void write(Writer &writer, std::uint64_t val);
+
+        // inverse of "write"
+        static matlab::data::Array read_array(Reader &reader);
+        static std::u16string read_string(Reader &reader);
+        static std::uint64_t read_uint64(Reader &reader);
+
+        // size of the data of an array in bytes (without the header),
+        // returns 0 for unsupported types
+        static std::size_t get_bytes(const matlab::data::Array &val) noexcept;
+    };
+
+    // 128 bit hash value
+    struct Digest
+    {
+        std::uint64_t h1;
+        std::uint64_t h2;
+
+        bool operator==(const Digest &other) const noexcept;
+        bool operator!=(const Digest &other) const noexcept;
+        bool operator<(const Digest &other) const noexcept;
+
+        // 32 hex characters
+        std::string to_string() const;
+    };
+
+    // A "Writer" which computes a (non cryptographic) 128 bit hash 
+    // of the byte stream
+    class Hasher : public Serializer::Writer
+    {
+    public:
+        Hasher() noexcept;
+
+        void write(const void *data, std::size_t n) override;
+
+        Digest get_digest() const noexcept;
+
+    private:
+        void process(std::uint64_t word) noexcept;
+
+    private:
+        std::uint64_t h1;
+        std::uint64_t h2;
+        std::uint64_t length;
+        std::uint64_t tail;
+        std::size_t n_tail;
+    };
+
+} // namespace MatlabPool
+
+#endif
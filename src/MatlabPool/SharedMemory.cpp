@@ -0,0 +1,170 @@
+#include "MatlabPool/SharedMemory.hpp"
+
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace MatlabPool
+{
+
+    SharedMemory::CannotCreate::CannotCreate(const char *step)
+    {
+        std::ostringstream os;
+        os << "cannot create shared memory (" << step << ")\n"
+#ifdef _WIN32
+           << "Error: " << GetLastError() << '\n';
+#else
+           << "Error: " << std::strerror(errno) << '\n';
+#endif
+        msg = os.str();
+    }
+    const char *SharedMemory::CannotCreate::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *SharedMemory::CannotCreate::identifier() const noexcept
+    {
+        return "CannotCreateSharedMemory";
+    }
+
+#ifdef _WIN32
+
+    SharedMemory::SharedMemory(std::size_t size)
+        : n(size),
+        ptr(nullptr),
+        file(INVALID_HANDLE_VALUE),
+        mapping(NULL)
+    {
+        char dir[MAX_PATH + 1];
+        char name[MAX_PATH + 1];
+        if (n == 0)
+            throw CannotCreate("size is equal zero");
+        if (!GetTempPathA(sizeof(dir), dir) ||
+            !GetTempFileNameA(dir, "MPS", 0, name))
+            throw CannotCreate("temp file");
+        path = name;
+
+        file = CreateFileA(name, GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_TEMPORARY, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            release();
+            throw CannotCreate("open");
+        }
+
+        auto size64 = static_cast<unsigned long long>(n);
+        mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+            DWORD(size64 >> 32), DWORD(size64 & 0xFFFFFFFF), NULL);
+        if (mapping == NULL)
+        {
+            release();
+            throw CannotCreate("mapping");
+        }
+
+        ptr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, n);
+        if (!ptr)
+        {
+            release();
+            throw CannotCreate("map view");
+        }
+    }
+
+    void SharedMemory::release() noexcept
+    {
+        if (ptr)
+            UnmapViewOfFile(ptr);
+        if (mapping != NULL)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        if (!path.empty())
+            DeleteFileA(path.c_str());
+        ptr = nullptr;
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+    }
+
+#else
+
+    SharedMemory::SharedMemory(std::size_t size)
+        : n(size),
+        ptr(nullptr),
+        fd(-1)
+    {
+        if (n == 0)
+            throw CannotCreate("size is equal zero");
+
+        const char *dir = std::getenv("TMPDIR");
+        path = dir && *dir ? dir : "/tmp";
+        path += "/MatlabPool_XXXXXX";
+
+        fd = mkstemp(&path[0]);
+        if (fd < 0)
+        {
+            path.clear();
+            throw CannotCreate("temp file");
+        }
+
+        if (ftruncate(fd, off_t(n)) != 0)
+        {
+            release();
+            throw CannotCreate("resize");
+        }
+
+        ptr = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            ptr = nullptr;
+            release();
+            throw CannotCreate("mmap");
+        }
+    }
+
+    void SharedMemory::release() noexcept
+    {
+        if (ptr)
+            munmap(ptr, n);
+        if (fd >= 0)
+            close(fd);
+        if (!path.empty())
+            unlink(path.c_str());
+        ptr = nullptr;
+        fd = -1;
+    }
+
+#endif
+
+    SharedMemory::~SharedMemory()
+    {
+        release();
+    }
+
+    void *SharedMemory::data() noexcept
+    {
+        return ptr;
+    }
+
+    const void *SharedMemory::data() const noexcept
+    {
+        return ptr;
+    }
+
+    std::size_t SharedMemory::size() const noexcept
+    {
+        return n;
+    }
+
+    const std::string &SharedMemory::get_path() const noexcept
+    {
+        return path;
+    }
+
+} // namespace MatlabPool
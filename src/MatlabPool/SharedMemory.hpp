@@ -0,0 +1,67 @@
+#ifndef MATLABPOOL_SHAREDMEMORY_HPP
+#define MATLABPOOL_SHAREDMEMORY_HPP
+
+#include "MatlabPool/Exception.hpp"
+
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace MatlabPool
+{
+    // This class creates a file backed shared memory region. The
+    // file can be mapped by other processes (e.g. a Matlab worker
+    // with "memmapfile"), so that they can write directly into the
+    // memory of this process. The file is removed by the destructor.
+    class SharedMemory
+    {
+    public:
+        class SharedMemoryException : public Exception
+        {
+        };
+        class CannotCreate : public SharedMemoryException
+        {
+        public:
+            CannotCreate(const char *step);
+            const char *what() const noexcept override;
+            const char *identifier() const noexcept override;
+
+        private:
+            std::string msg;
+        };
+
+    public:
+        SharedMemory(const SharedMemory &) = delete;
+        SharedMemory &operator=(const SharedMemory &) = delete;
+
+        SharedMemory(std::size_t size);
+        ~SharedMemory();
+
+        void *data() noexcept;
+        const void *data() const noexcept;
+        std::size_t size() const noexcept;
+
+        // path of the backing file
+        const std::string &get_path() const noexcept;
+
+    private:
+        // release all resources, also used if the construction fails
+        void release() noexcept;
+
+    private:
+        std::string path;
+        std::size_t n;
+        void *ptr;
+#ifdef _WIN32
+        HANDLE file;
+        HANDLE mapping;
+#else
+        int fd;
+#endif
+    };
+
+} // namespace MatlabPool
+
+#endif
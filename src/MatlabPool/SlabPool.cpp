@@ -0,0 +1,78 @@
+#include "MatlabPool/SlabPool.hpp"
+
+#include "MatlabPool/Assert.hpp"
+
+namespace MatlabPool
+{
+    SlabPool::SlabPool() noexcept
+        : blockSize(0),
+        freeList(nullptr)
+    {
+    }
+
+    SlabPool::~SlabPool()
+    {
+        for (void *slab : slabs)
+            ::operator delete(slab);
+    }
+
+    SlabPool &SlabPool::get(std::size_t size) noexcept
+    {
+        constexpr std::size_t n = max_block_size / granularity;
+        static SlabPool pools[n];
+        static std::once_flag init;
+        std::call_once(init, []() {
+            for (std::size_t i = 0; i < n; i++)
+                pools[i].blockSize = (i + 1) * granularity;
+        });
+
+        MATLABPOOL_ASSERT(0 < size && size <= max_block_size);
+        return pools[(size - 1) / granularity];
+    }
+
+    void *SlabPool::allocate()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!freeList)
+        {
+            std::size_t n = slab_size / blockSize;
+            slabs.reserve(slabs.size() + 1);
+            char *slab = static_cast<char *>(::operator new(n * blockSize));
+            slabs.push_back(slab);
+            count_heap_allocation();
+
+            for (std::size_t i = 0; i < n; i++)
+            {
+                FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + i * blockSize);
+                block->next = freeList;
+                freeList = block;
+            }
+        }
+
+        FreeBlock *block = freeList;
+        freeList = block->next;
+        return block;
+    }
+
+    void SlabPool::deallocate(void *ptr) noexcept
+    {
+        if (!ptr)
+            return;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        FreeBlock *block = static_cast<FreeBlock *>(ptr);
+        block->next = freeList;
+        freeList = block;
+    }
+
+    std::uint64_t SlabPool::get_heap_allocations() noexcept
+    {
+        return heapAllocations.load();
+    }
+
+    void SlabPool::count_heap_allocation() noexcept
+    {
+        ++heapAllocations;
+    }
+
+} // namespace MatlabPool
@@ -0,0 +1,137 @@
+#ifndef MATLABPOOL_SLABPOOL_HPP
+#define MATLABPOOL_SLABPOOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace MatlabPool
+{
+    // Thread safe pool of memory blocks with a fixed size. The blocks
+    // are taken from slabs, i.e. larger chunks of memory which are
+    // allocated on demand and released by the destructor. After a 
+    // warm-up phase all allocations are served without the heap, 
+    // this is used for the per job control blocks of the dispatch.
+    class SlabPool
+    {
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+    public:
+        // larger blocks are allocated on the heap
+        static constexpr std::size_t max_block_size = 1024;
+
+        SlabPool(const SlabPool &) = delete;
+        SlabPool &operator=(const SlabPool &) = delete;
+
+        ~SlabPool();
+
+        // pool for blocks with at least "size" bytes
+        static SlabPool &get(std::size_t size) noexcept;
+
+        void *allocate();
+        void deallocate(void *ptr) noexcept;
+
+        // heap allocations of all pools of this module, i.e. new slabs
+        // and blocks which are larger than "max_block_size"
+        static std::uint64_t get_heap_allocations() noexcept;
+
+        // count a heap allocation, which is not served by a pool
+        static void count_heap_allocation() noexcept;
+
+    private:
+        SlabPool() noexcept;
+
+    private:
+        static constexpr std::size_t granularity = 16;
+        static constexpr std::size_t slab_size = 16 * 1024;
+
+        std::size_t blockSize;
+        FreeBlock *freeList;        // mutex
+        std::vector<void *> slabs;  // mutex
+        std::mutex mutex;
+
+        inline static std::atomic<std::uint64_t> heapAllocations{ 0 };
+    };
+
+    // STL allocator based on the "SlabPool", allocations with more than
+    // "SlabPool::max_block_size" bytes use the heap
+    template <typename T>
+    class SlabAllocator
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+            "over-aligned types are not supported");
+
+    public:
+        using value_type = T;
+
+        SlabAllocator() noexcept {}
+
+        template <typename U>
+        SlabAllocator(const SlabAllocator<U> &) noexcept {}
+
+        T *allocate(std::size_t n)
+        {
+            if (is_small(n))
+                return static_cast<T *>(SlabPool::get(n * sizeof(T)).allocate());
+
+            SlabPool::count_heap_allocation();
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *ptr, std::size_t n) noexcept
+        {
+            if (is_small(n))
+                SlabPool::get(n * sizeof(T)).deallocate(ptr);
+            else
+                ::operator delete(ptr);
+        }
+
+        template <typename U>
+        bool operator==(const SlabAllocator<U> &) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const SlabAllocator<U> &) const noexcept { return false; }
+
+    private:
+        static bool is_small(std::size_t n) noexcept
+        {
+            return 0 < n && n <= SlabPool::max_block_size / sizeof(T);
+        }
+    };
+
+    // like "new" and "delete" with a "SlabAllocator"
+    template <typename T, typename... Args>
+    T *slab_new(Args &&... args)
+    {
+        SlabAllocator<T> alloc;
+        T *ptr = alloc.allocate(1);
+        try
+        {
+            return new (ptr) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            alloc.deallocate(ptr, 1);
+            throw;
+        }
+    }
+
+    template <typename T>
+    void slab_delete(T *ptr) noexcept
+    {
+        if (!ptr)
+            return;
+        ptr->~T();
+        SlabAllocator<T>().deallocate(ptr, 1);
+    }
+
+} // namespace MatlabPool
+
+#endif
@@ -1,5 +1,7 @@
 #include "MatlabPool/StreamBuf.hpp"
 
+#include <algorithm>
+
 namespace MatlabPool
 {
     
@@ -19,48 +21,214 @@ namespace MatlabPool
         return std::string(asciistr_ptr.get());
     }
 
-    std::size_t StreamBuf::BasicStringBuf::size() const noexcept
+    void convertUTF16StringToASCIIString(const std::u16string &str, std::string &dst)
     {
-        MATLABPOOL_ASSERT(pptr() >= pbase());
-        return pptr() - pbase();
+        dst.resize(str.size());
+        const char *u16_src = reinterpret_cast<const char *>(str.c_str());
+        for (size_t n = 0; n < str.size(); ++n)
+            dst[n] = u16_src[2 * n];
     }
-    bool StreamBuf::BasicStringBuf::empty() const noexcept
+
+    std::u16string convertASCIIStringToUTF16String(const std::string &str)
     {
-        return pptr() == pbase();
+        return std::u16string(str.begin(), str.end());
     }
 
-    StreamBuf::StreamBuf() : buffer(std::make_shared<BasicStringBuf>()) {}
+    StreamBuf::CaptureBuffer::CaptureBuffer(std::size_t limit) noexcept
+        : count(0), limit(limit), truncatedFlag(false)
+    {
+    }
+
+    StreamBuf::CaptureBuffer::~CaptureBuffer()
+    {
+        for (const auto &c : chunks)
+            SlabAllocator<char16_t>().deallocate(c.data, c.capacity);
+    }
 
-    std::shared_ptr<StringBuf> StreamBuf::get() const noexcept
+    std::u16string StreamBuf::CaptureBuffer::str() const
     {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::u16string result;
+        result.reserve(count);
+        for (const auto &c : chunks)
+            result.append(c.data, c.size);
+        if (truncatedFlag)
+            result += u"\n[output truncated]\n";
+        return result;
+    }
+
+    std::u16string StreamBuf::CaptureBuffer::read(std::size_t pos) const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::u16string result;
+        if (pos >= count)
+            return result;
+        result.reserve(count - pos);
+
+        // skip the chunks before "pos"
+        for (const auto &c : chunks)
+        {
+            if (pos >= c.size)
+            {
+                pos -= c.size;
+                continue;
+            }
+            result.append(c.data + pos, c.size - pos);
+            pos = 0;
+        }
+        return result;
+    }
+
+    std::size_t StreamBuf::CaptureBuffer::size() const noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return count;
+    }
+
+    bool StreamBuf::CaptureBuffer::empty() const noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return count == 0 && !truncatedFlag;
+    }
+
+    bool StreamBuf::CaptureBuffer::truncated() const noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return truncatedFlag;
+    }
+
+    std::streamsize StreamBuf::CaptureBuffer::xsputn(const char16_t *s, std::streamsize n)
+    {
+        MATLABPOOL_ASSERT(n >= 0);
+        std::unique_lock<std::mutex> lock(mutex);
+
+        std::size_t len = std::size_t(n);
+        if (len > limit - count)
+        {
+            len = limit - count;
+            truncatedFlag = true;
+        }
+
+        while (len > 0)
+        {
+            if (chunks.empty() || chunks.back().size == chunks.back().capacity)
+            {
+                // the chunks grow with the size of the buffer
+                std::size_t capacity = std::min(std::max(min_chunk, count), max_chunk);
+                if (chunks.size() == chunks.capacity())
+                    chunks.reserve(std::max(chunks.size() * 2, std::size_t(4)));
+                SlabAllocator<char16_t> alloc;
+                chunks.push_back({ alloc.allocate(capacity), 0, capacity });
+            }
+
+            Chunk &c = chunks.back();
+            std::size_t k = std::min(len, c.capacity - c.size);
+            std::copy(s, s + k, c.data + c.size);
+            c.size += k;
+            count += k;
+            s += k;
+            len -= k;
+        }
+
+        // the dropped characters count as written, otherwise the
+        // caller would retry them
+        return n;
+    }
+
+    StreamBuf::CaptureBuffer::int_type StreamBuf::CaptureBuffer::overflow(int_type ch)
+    {
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            char16_t c = traits_type::to_char_type(ch);
+            xsputn(&c, 1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    StreamBuf::StreamBuf() noexcept : limit(default_limit), readPos(0), capture(true) {}
+
+    // the buffers are allocated by a "SlabPool", because every job 
+    // has two buffers
+    StreamBuf::CaptureBuffer &StreamBuf::get_buffer()
+    {
+        if (!buffer)
+            buffer = std::allocate_shared<CaptureBuffer>(
+                SlabAllocator<CaptureBuffer>(), limit);
+        return *buffer;
+    }
+
+    std::shared_ptr<StringBuf> StreamBuf::get()
+    {
+        if (!capture)
+            return nullptr;
+        get_buffer();
         return std::static_pointer_cast<StringBuf>(buffer);
     }
 
     std::u16string StreamBuf::str() const
     {
-        return buffer->str();
+        return buffer ? buffer->str() : std::u16string();
     }
 
     bool StreamBuf::empty() const
     {
-        return buffer->empty();
+        return !buffer || buffer->empty();
+    }
+
+    bool StreamBuf::truncated() const
+    {
+        return buffer && buffer->truncated();
+    }
+
+    std::u16string StreamBuf::read_new()
+    {
+        if (!buffer)
+            return std::u16string();
+        std::u16string result = buffer->read(readPos);
+        readPos += result.size();
+        return result;
+    }
+
+    void StreamBuf::set_limit(std::size_t val) noexcept
+    {
+        limit = val;
+    }
+
+    void StreamBuf::set_capture(bool val) noexcept
+    {
+        capture = val;
+    }
+
+    bool StreamBuf::get_capture() const noexcept
+    {
+        return capture;
     }
 
     StreamBuf &StreamBuf::operator<<(const std::u16string &val)
     {
-        buffer->sputn(&val[0], val.size());
+        get_buffer().sputn(val.data(), val.size());
         return *this;
     }
     StreamBuf &StreamBuf::operator<<(const char16_t *val)
     {
-        buffer->sputn(val, strlen16(val));
+        get_buffer().sputn(val, strlen16(val));
         return *this;
     }
 
+    void StreamBuf::write_ascii(const std::string &val)
+    {
+        CaptureBuffer &buf = get_buffer();
+        for (char c : val)
+            buf.sputc(char16_t(c));
+    }
+
     void swap(StreamBuf &lhs, StreamBuf &rhs) noexcept
     {
         using std::swap;
         swap(rhs.buffer, lhs.buffer);
+        swap(rhs.limit, lhs.limit);
+        swap(rhs.readPos, lhs.readPos);
+        swap(rhs.capture, lhs.capture);
     }
 
     std::size_t StreamBuf::strlen16(const char16_t *strarg)
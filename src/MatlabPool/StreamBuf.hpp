@@ -2,58 +2,120 @@
 #define MATLABPOOL_STREAMBUF_HPP
 
 #include "MatlabPool/Assert.hpp"
+#include "MatlabPool/SlabPool.hpp"
 
 #include <memory>
-#include <sstream>
+#include <mutex>
+#include <streambuf>
 #include <string>
 #include <utility>
-#include <locale>
-#include <codecvt>
+#include <vector>
 
 namespace MatlabPool
 {
-    using StringBuf = std::basic_stringbuf<char16_t>;
+    // same type as matlab::execution::StreamBuffer
+    using StringBuf = std::basic_streambuf<char16_t>;
 
     // converts a std::u16string to a std::string by cutting the 
     // extra bytes
     std::string convertUTF16StringToASCIIString(const std::u16string &str);
 
+    // like above, but the memory of "dst" is reused
+    void convertUTF16StringToASCIIString(const std::u16string &str, std::string &dst);
+
+    // converts a std::string (only ASCII characters) to a std::u16string
+    std::u16string convertASCIIStringToUTF16String(const std::string &str);
+
     // this class works like a std::ostringstream but with char16_t 
     // characters. It also delivers a shared pointer to the string
-    // buffer, this is usefull for working with the Matlab Engine API
+    // buffer, this is usefull for working with the Matlab Engine API.
+    // The buffer is created with the first call of "get" or the first
+    // write, the memory for the characters with the first write.
     class StreamBuf
     {
-        // derived class for an access to the protected base class
-        // function. These protected functions are only used for
-        // computing the size and for checking whether no characters
-        // in the buffer. 
-        class BasicStringBuf : public StringBuf
+        // Thread safe append only buffer. The characters are stored
+        // in chunks, so that a write never moves the old characters.
+        // Characters beyond the limit are dropped. The chunks are
+        // allocated by a "SlabPool" (only the large chunks of a long
+        // output use the heap).
+        class CaptureBuffer : public StringBuf
         {
+            struct Chunk
+            {
+                char16_t *data;
+                std::size_t size;
+                std::size_t capacity;
+            };
+
         public:
+            CaptureBuffer(const CaptureBuffer &) = delete;
+            CaptureBuffer &operator=(const CaptureBuffer &) = delete;
+
+            CaptureBuffer(std::size_t limit) noexcept;
+            ~CaptureBuffer();
+
+            std::u16string str() const;
+
+            // characters from "pos" to the end of the buffer
+            std::u16string read(std::size_t pos) const;
+
             std::size_t size() const noexcept;
             bool empty() const noexcept;
+            bool truncated() const noexcept;
+
+        protected:
+            std::streamsize xsputn(const char16_t *s, std::streamsize n) override;
+            int_type overflow(int_type ch) override;
+
+        private:
+            std::vector<Chunk, SlabAllocator<Chunk>> chunks; // mutex
+            std::size_t count;            // mutex
+            std::size_t limit;            // mutex
+            bool truncatedFlag;           // mutex
+            mutable std::mutex mutex;
+
+            static constexpr std::size_t min_chunk = 256;
+            static constexpr std::size_t max_chunk = std::size_t(1) << 16;
         };
 
     public:
+        // default limit of the captured characters
+        static constexpr std::size_t default_limit = std::size_t(1) << 24;
+
         StreamBuf(const StreamBuf &) = delete;
         StreamBuf &operator=(const StreamBuf &) = delete;
 
-        StreamBuf();
+        StreamBuf() noexcept;
 
-        std::shared_ptr<StringBuf> get() const noexcept;
+        // buffer for the Matlab Engine API, returns a nullptr if 
+        // the capture is disabled
+        std::shared_ptr<StringBuf> get();
 
         std::u16string str() const;
 
         bool empty() const;
 
+        // check if characters were dropped because of the limit
+        bool truncated() const;
+
+        // the characters written since the last call, only these
+        // characters are copied (the buffer can be written by a worker
+        // at the same time)
+        std::u16string read_new();
+
+        // maximal number of stored characters, only effective before
+        // the first write
+        void set_limit(std::size_t limit) noexcept;
+
+        // a buffer without capture drops the output of the worker
+        void set_capture(bool val) noexcept;
+        bool get_capture() const noexcept;
+
         template <typename T>
         StreamBuf &operator<<(const T &val)
         {
-            static std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> conv;
-
-            auto tmp = std::u16string{conv.from_bytes(std::to_string(val))};
-            
-            buffer->sputn(&tmp[0], tmp.size());
+            // std::to_string creates only ASCII characters
+            write_ascii(std::to_string(val));
             return *this;
         }
 
@@ -66,10 +128,17 @@ namespace MatlabPool
         // like std::strlen
         std::size_t strlen16(const char16_t *strarg);
 
+        void write_ascii(const std::string &val);
+
+        CaptureBuffer &get_buffer();
+
     private:
-        std::shared_ptr<BasicStringBuf> buffer;
+        std::shared_ptr<CaptureBuffer> buffer;
+        std::size_t limit;
+        std::size_t readPos;
+        bool capture;
     };
 
 } // namespace MatlabPool
 
-#endif
\ No newline at end of file
+#endif
@@ -1,8 +1,34 @@
 #include "MatlabPool/Utilities.hpp"
 #include <algorithm>
+#include <sstream>
+#include <type_traits>
 
 namespace MatlabPool::Utilities
 {
+    UnsupportedType::UnsupportedType(matlab::data::ArrayType type)
+    {
+        std::ostringstream os;
+        os << "unsupported array type (ArrayType: " << int(type) << ")";
+        msg = os.str();
+    }
+    const char *UnsupportedType::what() const noexcept
+    {
+        return msg.c_str();
+    }
+    const char *UnsupportedType::identifier() const noexcept
+    {
+        return "UnsupportedType";
+    }
+
+    const char *SizeMismatch::what() const noexcept
+    {
+        return "the size of the array does not match the slice";
+    }
+    const char *SizeMismatch::identifier() const noexcept
+    {
+        return "SizeMismatch";
+    }
+
     matlab::data::StructArray addFields(matlab::data::StructArray val,
                                         std::vector<std::string> fieldsNew)
     {
@@ -30,4 +56,172 @@ namespace MatlabPool::Utilities
         return valNew;
     }
 
-} // namespace MatlabPool::Utilities
\ No newline at end of file
+    bool isInside(const Slice &slice, const std::vector<std::size_t> &dims) noexcept
+    {
+        if (slice.offset.size() != dims.size() || slice.dims.size() != dims.size())
+            return false;
+
+        for (std::size_t i = 0; i < dims.size(); i++)
+            if (slice.offset[i] + slice.dims[i] > dims[i])
+                return false;
+
+        return true;
+    }
+
+    namespace
+    {
+        template <typename T>
+        void copyToSliceTyped(matlab::data::Array &dst, const matlab::data::Array &src,
+                              const Slice &slice)
+        {
+            std::vector<std::size_t> dims = dst.getDimensions();
+            std::size_t nd = dims.size();
+            std::size_t rows = slice.dims[0];
+            if (rows == 0 || src.getNumberOfElements() == 0)
+                return;
+
+            matlab::data::TypedArray<T> d(std::move(dst));
+            const matlab::data::TypedArray<T> s(src);
+
+            // copy column by column, "idx" is the index of the
+            // current column inside of the slice
+            std::vector<std::size_t> idx(nd, 0);
+            auto it_src = s.begin();
+            auto it_dst = d.begin();
+            std::size_t cols = src.getNumberOfElements() / rows;
+            for (std::size_t c = 0; c < cols; c++)
+            {
+                std::size_t pos = 0;
+                std::size_t stride = 1;
+                for (std::size_t k = 0; k < nd; k++)
+                {
+                    pos += (slice.offset[k] + idx[k]) * stride;
+                    stride *= dims[k];
+                }
+                std::copy(it_src, it_src + rows, it_dst + pos);
+                it_src += rows;
+
+                for (std::size_t k = 1; k < nd; k++)
+                {
+                    if (++idx[k] < slice.dims[k])
+                        break;
+                    idx[k] = 0;
+                }
+            }
+            dst = std::move(d);
+        }
+
+        template <typename T>
+        matlab::data::Array copyFromSliceTyped(const matlab::data::Array &src,
+                                               const Slice &slice)
+        {
+            matlab::data::ArrayFactory factory;
+            auto d = factory.createArray<T>(slice.dims);
+            std::vector<std::size_t> dims = src.getDimensions();
+            std::size_t nd = dims.size();
+            std::size_t rows = slice.dims[0];
+            if (rows == 0 || d.getNumberOfElements() == 0)
+                return d;
+
+            const matlab::data::TypedArray<T> s(src);
+
+            // the counterpart of "copyToSliceTyped"
+            std::vector<std::size_t> idx(nd, 0);
+            auto it_src = s.begin();
+            auto it_dst = d.begin();
+            std::size_t cols = d.getNumberOfElements() / rows;
+            for (std::size_t c = 0; c < cols; c++)
+            {
+                std::size_t pos = 0;
+                std::size_t stride = 1;
+                for (std::size_t k = 0; k < nd; k++)
+                {
+                    pos += (slice.offset[k] + idx[k]) * stride;
+                    stride *= dims[k];
+                }
+                std::copy(it_src + pos, it_src + pos + rows, it_dst);
+                it_dst += rows;
+
+                for (std::size_t k = 1; k < nd; k++)
+                {
+                    if (++idx[k] < slice.dims[k])
+                        break;
+                    idx[k] = 0;
+                }
+            }
+            return d;
+        }
+
+        struct ClassName
+        {
+            matlab::data::ArrayType type;
+            const char *name;
+        };
+
+        constexpr ClassName classNames[] =
+        {
+            { matlab::data::ArrayType::DOUBLE, "double" },
+            { matlab::data::ArrayType::SINGLE, "single" },
+            { matlab::data::ArrayType::INT8, "int8" },
+            { matlab::data::ArrayType::UINT8, "uint8" },
+            { matlab::data::ArrayType::INT16, "int16" },
+            { matlab::data::ArrayType::UINT16, "uint16" },
+            { matlab::data::ArrayType::INT32, "int32" },
+            { matlab::data::ArrayType::UINT32, "uint32" },
+            { matlab::data::ArrayType::INT64, "int64" },
+            { matlab::data::ArrayType::UINT64, "uint64" },
+        };
+    } // namespace
+
+    const char *get_className(matlab::data::ArrayType type)
+    {
+        for (const auto &e : classNames)
+            if (e.type == type)
+                return e.name;
+        throw UnsupportedType(type);
+    }
+
+    void copyToSlice(matlab::data::Array &dst, const matlab::data::Array &src,
+                     const Slice &slice)
+    {
+        if (dst.getType() != src.getType())
+            throw UnsupportedType(src.getType());
+        if (!isInside(slice, dst.getDimensions()))
+            throw SizeMismatch();
+
+        // the dimensions of "src" without trailing singleton
+        // dimensions must match the slice
+        std::vector<std::size_t> dims = src.getDimensions();
+        if (dims.size() > slice.dims.size())
+            throw SizeMismatch();
+        dims.resize(slice.dims.size(), 1);
+        if (dims != slice.dims)
+            throw SizeMismatch();
+
+        visitNumeric(dst.getType(), [&](auto *p) {
+            using T = std::remove_pointer_t<decltype(p)>;
+            copyToSliceTyped<T>(dst, src, slice);
+        });
+    }
+
+    matlab::data::Array copyFromSlice(const matlab::data::Array &src,
+                                      const Slice &slice)
+    {
+        if (!isInside(slice, src.getDimensions()))
+            throw SizeMismatch();
+
+        return visitNumeric(src.getType(), [&](auto *p) {
+            using T = std::remove_pointer_t<decltype(p)>;
+            return copyFromSliceTyped<T>(src, slice);
+        });
+    }
+
+    matlab::data::ArrayType get_arrayType(const std::string &className)
+    {
+        for (const auto &e : classNames)
+            if (className == e.name)
+                return e.type;
+        throw UnsupportedType(matlab::data::ArrayType::UNKNOWN);
+    }
+
+} // namespace MatlabPool::Utilities
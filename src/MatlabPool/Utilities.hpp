@@ -1,12 +1,42 @@
 #ifndef MATLABPOOL_UTILITIES_HPP
 #define MATLABPOOL_UTILITIES_HPP
 
+#include "MatlabPool/Exception.hpp"
+
 #include "MatlabDataArray.hpp"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 namespace MatlabPool::Utilities
 {
+    class UnsupportedType : public Exception
+    {
+    public:
+        UnsupportedType(matlab::data::ArrayType type);
+        const char *what() const noexcept override;
+        const char *identifier() const noexcept override;
+
+    private:
+        std::string msg;
+    };
+
+    class SizeMismatch : public Exception
+    {
+    public:
+        const char *what() const noexcept override;
+        const char *identifier() const noexcept override;
+    };
+
+    // describes a block of an array, e.g. a single tile of an image.
+    // The offset is zero based, both vectors have one entry for
+    // each dimension of the array
+    struct Slice
+    {
+        std::vector<std::size_t> offset;
+        std::vector<std::size_t> dims;
+    };
+
     // unfortunately all fields of a matlab struct must be defined 
     // during the construction. This function functions adds new 
     // fields to the struct, by creating a new struct and swaping
@@ -14,6 +44,60 @@ namespace MatlabPool::Utilities
     matlab::data::StructArray addFields(matlab::data::StructArray val,
                                         std::vector<std::string> fieldsNew);
 
+    // check if a slice fits into an array with the dimensions "dims"
+    bool isInside(const Slice &slice, const std::vector<std::size_t> &dims) noexcept;
+
+    // copy the array "src" into the slice of "dst" (column major),
+    // both arrays must have the same real numeric type and "src"
+    // must have the size of the slice
+    void copyToSlice(matlab::data::Array &dst, const matlab::data::Array &src,
+                     const Slice &slice);
+
+    // copy the slice of "src" into a new array with the size of the
+    // slice, "src" must have a real numeric type
+    matlab::data::Array copyFromSlice(const matlab::data::Array &src,
+                                      const Slice &slice);
+
+    // matlab class name of a real numeric array type, e.g. "double"
+    const char *get_className(matlab::data::ArrayType type);
+
+    // inverse function of "get_className"
+    matlab::data::ArrayType get_arrayType(const std::string &className);
+
+    // calls "fun" with a null pointer to the C++ element type of a
+    // real numeric matlab array type, e.g. "fun((double *)nullptr)".
+    // This is the counterpart of a switch over all array types
+    template <typename FUN>
+    decltype(auto) visitNumeric(matlab::data::ArrayType type, FUN &&fun)
+    {
+        using matlab::data::ArrayType;
+        switch (type)
+        {
+        case ArrayType::DOUBLE:
+            return fun(static_cast<double *>(nullptr));
+        case ArrayType::SINGLE:
+            return fun(static_cast<float *>(nullptr));
+        case ArrayType::INT8:
+            return fun(static_cast<std::int8_t *>(nullptr));
+        case ArrayType::UINT8:
+            return fun(static_cast<std::uint8_t *>(nullptr));
+        case ArrayType::INT16:
+            return fun(static_cast<std::int16_t *>(nullptr));
+        case ArrayType::UINT16:
+            return fun(static_cast<std::uint16_t *>(nullptr));
+        case ArrayType::INT32:
+            return fun(static_cast<std::int32_t *>(nullptr));
+        case ArrayType::UINT32:
+            return fun(static_cast<std::uint32_t *>(nullptr));
+        case ArrayType::INT64:
+            return fun(static_cast<std::int64_t *>(nullptr));
+        case ArrayType::UINT64:
+            return fun(static_cast<std::uint64_t *>(nullptr));
+        default:
+            throw UnsupportedType(type);
+        }
+    }
+
 } // namespace MatlabPool::Utilities
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,94 @@
+#include "MatlabPoolLib/ArgumentCache.hpp"
+
+#include <algorithm>
+
+namespace MatlabPool
+{
+
+    ArgumentCache::ArgumentCache(std::size_t capacity) noexcept
+        : bytes(0),
+        capacity(capacity),
+        resetFlag(false)
+    {
+    }
+
+    void ArgumentCache::set_capacity(std::size_t val)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        capacity = val;
+        shrink();
+    }
+
+    bool ArgumentCache::lookup(const Digest &digest)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = entries.find(digest);
+        if (it == entries.end())
+            return false;
+
+        lru.splice(lru.begin(), lru, it->second);
+        return true;
+    }
+
+    bool ArgumentCache::insert(const Digest &digest, std::size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (size > capacity || entries.count(digest))
+            return false;
+
+        // the entry may be evicted by the same job, e.g. the worker 
+        // stores it again and must not remove it afterwards
+        evicted.erase(std::remove(evicted.begin(), evicted.end(), digest), evicted.end());
+
+        lru.emplace_front(digest, size);
+        entries[digest] = lru.begin();
+        bytes += size;
+        shrink();
+        return true;
+    }
+
+    std::vector<Digest> ArgumentCache::pop_evicted()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::vector<Digest> tmp;
+        tmp.swap(evicted);
+        return tmp;
+    }
+
+    bool ArgumentCache::has_evicted() noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return !evicted.empty();
+    }
+
+    void ArgumentCache::reset() noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        lru.clear();
+        entries.clear();
+        evicted.clear();
+        bytes = 0;
+        resetFlag = true;
+    }
+
+    bool ArgumentCache::pop_reset() noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        bool tmp = resetFlag;
+        resetFlag = false;
+        return tmp;
+    }
+
+    void ArgumentCache::shrink()
+    {
+        while (bytes > capacity)
+        {
+            const Entry &e = lru.back();
+            bytes -= e.second;
+            evicted.push_back(e.first);
+            entries.erase(e.first);
+            lru.pop_back();
+        }
+    }
+
+} // namespace MatlabPool
@@ -0,0 +1,70 @@
+#ifndef MATLABPOOL_ARGUMENTCACHE_HPP
+#define MATLABPOOL_ARGUMENTCACHE_HPP
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "MatlabPool/Serializer.hpp"
+
+namespace MatlabPool
+{
+    // Record of the arguments which are cached by a single worker 
+    // (see "MatlabPoolWorker.arg_cache"). The entries are identified
+    // by the hash of their content. If the size of all entries 
+    // exceeds the capacity, the least recently used entries are
+    // removed. The worker must remove them as well, so the removed
+    // entries are collected until "pop_evicted" is called.
+    class ArgumentCache
+    {
+        using Entry = std::pair<Digest, std::size_t>;
+
+    public:
+        ArgumentCache(const ArgumentCache &) = delete;
+        ArgumentCache &operator=(const ArgumentCache &) = delete;
+
+        ArgumentCache(std::size_t capacity = 0) noexcept;
+
+        // capacity in bytes, zero disables the cache
+        void set_capacity(std::size_t capacity);
+
+        // check if the worker holds an argument, the entry is marked
+        // as recently used
+        bool lookup(const Digest &digest);
+
+        // add an argument, returns false if the argument does not
+        // fit into the cache. A pending eviction of the argument is 
+        // dropped.
+        bool insert(const Digest &digest, std::size_t bytes);
+
+        // entries which are removed since the last call
+        std::vector<Digest> pop_evicted();
+
+        bool has_evicted() noexcept;
+
+        // forget all entries, the worker must clear its cache as well
+        // (e.g. a job was canceled before the worker stored its 
+        // arguments)
+        void reset() noexcept;
+
+        // check if the worker must clear its cache
+        bool pop_reset() noexcept;
+
+    private:
+        // remove entries until the size fits the capacity
+        void shrink();
+
+    private:
+        std::list<Entry> lru;                                   // mutex
+        std::map<Digest, std::list<Entry>::iterator> entries;   // mutex
+        std::vector<Digest> evicted;                            // mutex
+        std::size_t bytes;                                      // mutex
+        std::size_t capacity;                                   // mutex
+        bool resetFlag;                                         // mutex
+        std::mutex mutex;
+    };
+
+} // namespace MatlabPool
+
+#endif
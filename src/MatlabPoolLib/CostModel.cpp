@@ -0,0 +1,48 @@
+#include "MatlabPoolLib/CostModel.hpp"
+
+#include "MatlabPool/Serializer.hpp"
+
+namespace MatlabPool
+{
+    void CostModel::add(const std::u16string &fun, std::size_t bytes, double seconds)
+    {
+        Entry &entry = entries[fun];
+        entry.all.add(seconds);
+        entry.sizes[size_class(bytes)].add(seconds);
+    }
+
+    const RuntimeStats *CostModel::get_stats(const std::u16string &fun) const noexcept
+    {
+        auto it = entries.find(fun);
+        return it != entries.end() ? &it->second.all : nullptr;
+    }
+
+    double CostModel::estimate(const std::u16string &fun, std::size_t bytes) const
+    {
+        auto it = entries.find(fun);
+        if (it == entries.end())
+            return unknown;
+
+        auto it_size = it->second.sizes.find(size_class(bytes));
+        if (it_size != it->second.sizes.end() && it_size->second.count() >= min_samples)
+            return it_size->second.median();
+        return it->second.all.median();
+    }
+
+    std::size_t CostModel::get_bytes(JobFeval &job) noexcept
+    {
+        std::size_t bytes = 0;
+        for (const auto &arg : job.get_args())
+            bytes += Serializer::get_bytes(arg);
+        return bytes;
+    }
+
+    unsigned int CostModel::size_class(std::size_t bytes) noexcept
+    {
+        unsigned int n = 0;
+        for (; bytes > 1; bytes >>= 1)
+            ++n;
+        return n;
+    }
+
+} // namespace MatlabPool
@@ -0,0 +1,53 @@
+#ifndef MATLABPOOL_COSTMODEL_HPP
+#define MATLABPOOL_COSTMODEL_HPP
+
+#include "MatlabPool/JobFeval.hpp"
+#include "MatlabPoolLib/RuntimeStats.hpp"
+
+#include <map>
+#include <string>
+
+namespace MatlabPool
+{
+    // Runtime model of the jobs, built from the runtimes of finished
+    // jobs. The runtimes are recorded per function and per size class
+    // of the arguments (the bytes of all arguments rounded down to a
+    // power of two). The estimate of a size class is used as soon as
+    // it has enough samples, otherwise the estimate of the function.
+    class CostModel
+    {
+        struct Entry
+        {
+            RuntimeStats all;
+            std::map<unsigned int, RuntimeStats> sizes;
+        };
+
+    public:
+        static constexpr double unknown = -1.0;
+
+        // record the runtime of a finished job
+        void add(const std::u16string &fun, std::size_t bytes, double seconds);
+
+        // runtimes of all jobs of a function, nullptr without samples
+        const RuntimeStats *get_stats(const std::u16string &fun) const noexcept;
+
+        // expected runtime in seconds, "unknown" without samples
+        double estimate(const std::u16string &fun, std::size_t bytes) const;
+
+        // bytes of all arguments of a job
+        static std::size_t get_bytes(JobFeval &job) noexcept;
+
+    private:
+        static unsigned int size_class(std::size_t bytes) noexcept;
+
+        // a size class needs a few samples to replace the estimate of
+        // the function
+        static constexpr std::size_t min_samples = 3;
+
+    private:
+        std::map<std::u16string, Entry> entries;
+    };
+
+} // namespace MatlabPool
+
+#endif
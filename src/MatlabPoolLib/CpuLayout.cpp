@@ -0,0 +1,226 @@
+#include "MatlabPoolLib/CpuLayout.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+namespace MatlabPool
+{
+    const CpuSet CpuLayout::none;
+
+    CpuLayout::CpuLayout(std::size_t n, std::size_t cpusPerWorker, bool numaSpread)
+    {
+        CpuSet cpus = available();
+        if (cpus.empty() || n == 0)
+            return;
+        if (cpusPerWorker == 0)
+            cpusPerWorker = std::max(cpus.size() / n, std::size_t(1));
+
+        std::vector<CpuSet> groups;
+        if (numaSpread)
+            groups = numa_nodes(cpus);
+        if (groups.empty())
+        {
+            groups.push_back(std::move(cpus));
+            numaSpread = false;
+        }
+
+        // split the nodes into sets, a node with less CPUs than 
+        // "cpusPerWorker" forms a single set
+        std::vector<std::vector<CpuSet>> split(groups.size());
+        for (std::size_t g = 0; g < groups.size(); g++)
+        {
+            const CpuSet &group = groups[g];
+            for (std::size_t i = 0; i < group.size(); i += cpusPerWorker)
+            {
+                if (i > 0 && i + cpusPerWorker > group.size())
+                    break;
+                auto last = std::min(group.size(), i + cpusPerWorker);
+                split[g].emplace_back(group.begin() + i, group.begin() + last);
+            }
+        }
+
+        // round-robin over the nodes
+        for (std::size_t k = 0;; k++)
+        {
+            bool any = false;
+            for (std::size_t g = 0; g < split.size(); g++)
+            {
+                if (k < split[g].size())
+                {
+                    sets.push_back(std::move(split[g][k]));
+                    nodes.push_back(numaSpread ? int(g) : -1);
+                    any = true;
+                }
+            }
+            if (!any)
+                break;
+        }
+    }
+
+    bool CpuLayout::empty() const noexcept
+    {
+        return sets.empty();
+    }
+
+    const CpuSet &CpuLayout::get_cpus(std::size_t workerID) const noexcept
+    {
+        return workerID < sets.size() ? sets[workerID] : none;
+    }
+
+    int CpuLayout::get_node(std::size_t workerID) const noexcept
+    {
+        return workerID < nodes.size() ? nodes[workerID] : -1;
+    }
+
+#ifdef _WIN32
+
+    bool CpuLayout::apply(std::uint64_t pid, const CpuSet &cpus) noexcept
+    {
+        DWORD_PTR mask = 0;
+        for (unsigned int cpu : cpus.empty() ? available() : cpus)
+            if (cpu < 8 * sizeof(DWORD_PTR))
+                mask |= DWORD_PTR(1) << cpu;
+        if (mask == 0)
+            return false;
+
+        HANDLE process = OpenProcess(PROCESS_SET_INFORMATION, FALSE, DWORD(pid));
+        if (process == NULL)
+            return false;
+        bool ok = SetProcessAffinityMask(process, mask) != 0;
+        CloseHandle(process);
+        return ok;
+    }
+
+    CpuSet CpuLayout::available()
+    {
+        CpuSet cpus;
+        DWORD_PTR mask, system;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &mask, &system))
+            for (unsigned int i = 0; i < 8 * sizeof(DWORD_PTR); i++)
+                if (mask & (DWORD_PTR(1) << i))
+                    cpus.push_back(i);
+        return cpus;
+    }
+
+    std::vector<CpuSet> CpuLayout::numa_nodes(const CpuSet &)
+    {
+        return {};
+    }
+
+#elif defined(__linux__)
+
+    bool CpuLayout::apply(std::uint64_t pid, const CpuSet &cpus) noexcept
+    {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (unsigned int cpu : cpus.empty() ? available() : cpus)
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &mask);
+        if (CPU_COUNT(&mask) == 0)
+            return false;
+
+        // the affinity is a property of a thread, the new threads of 
+        // the process inherit it from their creator
+        std::string dir = "/proc/" + std::to_string(pid) + "/task";
+        DIR *tasks = opendir(dir.c_str());
+        if (!tasks)
+            return false;
+        bool ok = true;
+        while (dirent *entry = readdir(tasks))
+        {
+            if (entry->d_name[0] == '.')
+                continue;
+            pid_t tid = pid_t(std::strtol(entry->d_name, nullptr, 10));
+            if (sched_setaffinity(tid, sizeof(mask), &mask) != 0)
+                ok = false;
+        }
+        closedir(tasks);
+        return ok;
+    }
+
+    CpuSet CpuLayout::available()
+    {
+        CpuSet cpus;
+        cpu_set_t mask;
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+            for (unsigned int i = 0; i < CPU_SETSIZE; i++)
+                if (CPU_ISSET(i, &mask))
+                    cpus.push_back(i);
+        return cpus;
+    }
+
+    std::vector<CpuSet> CpuLayout::numa_nodes(const CpuSet &cpus)
+    {
+        std::vector<CpuSet> result;
+        for (unsigned int node = 0;; node++)
+        {
+            std::ifstream file("/sys/devices/system/node/node" + 
+                std::to_string(node) + "/cpulist");
+            std::string list;
+            if (!file || !std::getline(file, list))
+                break;
+
+            CpuSet tmp;
+            for (unsigned int cpu : parse_list(list))
+                if (std::binary_search(cpus.begin(), cpus.end(), cpu))
+                    tmp.push_back(cpu);
+            if (!tmp.empty())
+                result.push_back(std::move(tmp));
+        }
+        return result.size() > 1 ? result : std::vector<CpuSet>();
+    }
+
+#else
+
+    bool CpuLayout::apply(std::uint64_t, const CpuSet &) noexcept
+    {
+        return false;
+    }
+
+    CpuSet CpuLayout::available()
+    {
+        CpuSet cpus(std::max(std::thread::hardware_concurrency(), 1u));
+        for (unsigned int i = 0; i < cpus.size(); i++)
+            cpus[i] = i;
+        return cpus;
+    }
+
+    std::vector<CpuSet> CpuLayout::numa_nodes(const CpuSet &)
+    {
+        return {};
+    }
+
+#endif
+
+    CpuSet CpuLayout::parse_list(const std::string &list)
+    {
+        CpuSet cpus;
+        std::istringstream is(list);
+        std::string range;
+        while (std::getline(is, range, ','))
+        {
+            unsigned int first;
+            std::istringstream r(range);
+            if (!(r >> first))
+                continue;
+            unsigned int last = first;
+            char sep;
+            if (r >> sep && sep == '-')
+                r >> last;
+            for (unsigned int i = first; i <= last; i++)
+                cpus.push_back(i);
+        }
+        return cpus;
+    }
+
+} // namespace MatlabPool
@@ -0,0 +1,59 @@
+#ifndef MATLABPOOL_CPULAYOUT_HPP
+#define MATLABPOOL_CPULAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MatlabPool
+{
+    using CpuSet = std::vector<unsigned int>;
+
+    // Disjoint sets of CPUs for the workers. The CPUs are taken from 
+    // the CPUs which are available to this process. With "numaSpread"
+    // the sets are assigned round-robin over the NUMA nodes and every
+    // set lies within a single node. If there are more workers than 
+    // sets, the remaining workers are not pinned. An empty layout 
+    // disables the pinning.
+    class CpuLayout
+    {
+    public:
+        CpuLayout() = default;
+
+        // "cpusPerWorker" equal zero divides the CPUs evenly between 
+        // "n" workers
+        CpuLayout(std::size_t n, std::size_t cpusPerWorker, bool numaSpread);
+
+        bool empty() const noexcept;
+
+        // CPU set of a worker, empty if the worker is not pinned
+        const CpuSet &get_cpus(std::size_t workerID) const noexcept;
+
+        // NUMA node of a worker, -1 if unknown
+        int get_node(std::size_t workerID) const noexcept;
+
+        // bind all threads of a process to the CPUs, an empty set 
+        // releases the binding, returns false if it is not supported
+        static bool apply(std::uint64_t pid, const CpuSet &cpus) noexcept;
+
+        // CPUs which are available to this process
+        static CpuSet available();
+
+    private:
+        // CPUs of the NUMA nodes (only the available CPUs), empty if 
+        // the nodes are unknown
+        static std::vector<CpuSet> numa_nodes(const CpuSet &cpus);
+
+        // parse a list like "0-3,8,10-11"
+        static CpuSet parse_list(const std::string &list);
+
+    private:
+        std::vector<CpuSet> sets;
+        std::vector<int> nodes;
+        static const CpuSet none;
+    };
+
+} // namespace MatlabPool
+
+#endif
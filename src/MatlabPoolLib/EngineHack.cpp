@@ -1,9 +1,75 @@
 #include "MatlabPoolLib/EngineHack.hpp"
 
+#include <fstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#ifndef MATLABPOOL_WORKER_PATH
+#define MATLABPOOL_WORKER_PATH "."
+#endif
+
+// directory of the package "+MatlabPoolWorker"
+static constexpr const char worker_path[] = MATLABPOOL_WORKER_PATH;
+static constexpr const char worker_dispatcher[] = "MatlabPoolWorker.run";
+
 namespace MatlabPool
 {
-    EngineHack::EngineHack(const std::vector<std::u16string> &options)
-        : matlab::engine::MATLABEngine(start_matlabasync(options).get()) {}
+    EngineHack::EngineHack(const std::vector<std::u16string> &options,
+        const CpuSet &cpus)
+        : matlab::engine::MATLABEngine(start_matlabasync(options).get()),
+        pid(0),
+        resetTemplates(false),
+        resetResults(false)
+    {
+        eval(u"addpath('" + convertASCIIStringToUTF16String(worker_path) + u"')");
+
+        matlab::data::TypedArray<double> id = feval(u"feature",
+            factory.createCharArray("getpid"));
+        pid = std::uint64_t(id[0]);
+
+        // the BLAS threads of the engine should not exceed its CPUs
+        if (!cpus.empty() && pin(cpus))
+            feval(u"maxNumCompThreads", 0, { factory.createScalar<double>(double(cpus.size())) });
+    }
+
+    std::uint64_t EngineHack::get_pid() const noexcept
+    {
+        return pid;
+    }
+
+    std::size_t EngineHack::get_memory() const noexcept
+    {
+#ifdef __linux__
+        // second field: resident pages
+        std::ifstream file("/proc/" + std::to_string(pid) + "/statm");
+        std::size_t size, resident;
+        if (file >> size >> resident)
+            return resident * std::size_t(sysconf(_SC_PAGESIZE));
+#endif
+        return 0;
+    }
+
+    bool EngineHack::pin(const CpuSet &val) noexcept
+    {
+        if (!CpuLayout::apply(pid, val))
+            return false;
+        try
+        {
+            cpus = val;
+        }
+        catch (...)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    const CpuSet &EngineHack::get_cpus() const noexcept
+    {
+        return cpus;
+    }
 
     // this function is copied and adjusted accordingly, source:
     //   matlabroot/extern/include/cppmex/detail/mexApiAdapterImpl.hpp
@@ -13,56 +79,335 @@ namespace MatlabPool
         using namespace matlab::execution;
         using matlab::data::impl::ArrayImpl;
 
-        size_t nrhs = job.get_args().size();
+        // replace arguments which are already cached by the worker
+        JobFuture::Spec extra;
+        replaced.clear();
+        apply_cache(job, extra);
+        apply_template(job, extra);
+        apply_deps(job, extra);
+        std::unique_ptr<Resend> resend = replaced.empty() ? nullptr : make_resend(job, extra);
 
-        std::unique_ptr<ArrayImpl *, void (*)(ArrayImpl **)> argsImplPtr(
-            new ArrayImpl *[nrhs],
-            [](ArrayImpl **ptr)
+        // jobs with a specification are evaluated by the worker side
+        // dispatcher: MatlabPoolWorker.run(spec, fun, args...)
+        const auto &tmpl = job.get_template();
+        const char *funstr;
+        prefix.clear();
+        if (job.get_spec().empty() && extra.empty())
+        {
+            if (tmpl)
             {
-                delete[] ptr;
+                funstr = tmpl->funAscii.c_str();
             }
-        );
+            else
+            {
+                MatlabPool::convertUTF16StringToASCIIString(job.get_cmd(), funstrBuf);
+                funstr = funstrBuf.c_str();
+            }
+        }
+        else
+        {
+            funstr = worker_dispatcher;
+            prefix.push_back(create_spec(job.get_spec(), extra));
+            prefix.push_back(tmpl ? tmpl->funArray : factory.createCharArray(job.get_cmd()));
+        }
+
+        // the buffers of this object are reused, so that the dispatch
+        // does not allocate memory after a warm-up phase
+        size_t nrhs = prefix.size() + job.get_args().size();
+        argsImpl.resize(nrhs);
 
-        ArrayImpl **argsImpl = argsImplPtr.get();
         size_t i = 0;
+        for (auto &e : prefix)
+            argsImpl[i++] = matlab::data::detail::Access::getImpl<ArrayImpl>(std::move(e));
         for (auto &e : job.get_args())
             argsImpl[i++] = matlab::data::detail::Access::getImpl<ArrayImpl>(std::move(e));
 
-        std::promise<std::vector<matlab::data::Array>> *p =
-            new std::promise<std::vector<matlab::data::Array>>();
-
-        MatlabPromiseHack *p_hack = new MatlabPromiseHack{ p, std::move(notifier) };
+        MatlabPromiseHack *p_hack = slab_new<MatlabPromiseHack>(MatlabPromiseHack{
+            std::promise<Result>(std::allocator_arg, SlabAllocator<Result>()),
+            std::move(notifier), std::move(resend) });
 
-        std::future<std::vector<matlab::data::Array>> f = p->get_future();
+        std::future<Result> f = p_hack->prom.get_future();
 
-        // the maltab implementation will call 'delete output' and 
-        // 'delete error', so we have to copy it
-        void *output = job.get_outBuf().get()
-            ? new std::shared_ptr<StreamBuffer>(job.get_outBuf().get())
+        // the maltab implementation will call 'delete_stream_buffer'
+        // for 'output' and 'error', so we have to copy it (a nullptr
+        // disables the capture)
+        std::shared_ptr<StreamBuffer> outBuf = job.get_outBuf().get();
+        std::shared_ptr<StreamBuffer> errBuf = job.get_errBuf().get();
+        void *output = outBuf
+            ? slab_new<std::shared_ptr<StreamBuffer>>(std::move(outBuf))
             : nullptr;
-        void *error = job.get_errBuf().get()
-            ? new std::shared_ptr<StreamBuffer>(job.get_errBuf().get())
+        void *error = errBuf
+            ? slab_new<std::shared_ptr<StreamBuffer>>(std::move(errBuf))
             : nullptr;
 
-        std::string funstr = MatlabPool::convertUTF16StringToASCIIString(job.get_cmd());
-
         uintptr_t handle = cpp_engine_feval_with_completion(
             matlabHandle,
-            funstr.c_str(),
-            job.get_nlhs(), false, argsImpl, nrhs,
+            funstr,
+            job.is_resident() ? 1 : job.get_nlhs(), false, argsImpl.data(), nrhs,
             set_feval_promise_data_hack,
             set_feval_promise_exception_hack,
             p_hack, output, error,
             &writeToStreamBuffer,
-            &deleteStreamBufferImpl
+            &delete_stream_buffer
         );
 
-        job.set_future(FutureResult<std::vector<matlab::data::Array>>(
+        job.set_future(FutureResult<Result>(
             std::move(f),
-            std::make_shared<TaskReference>(handle, cpp_engine_cancel_feval_with_completion))
+            std::allocate_shared<TaskReference>(SlabAllocator<TaskReference>(),
+                handle, cpp_engine_cancel_feval_with_completion))
         );
     }
 
+    ArgumentCache &EngineHack::get_argumentCache() noexcept
+    {
+        return argCache;
+    }
+
+    void EngineHack::unpin_template(TemplateID id)
+    {
+        std::unique_lock<std::mutex> lock(mutex_templates);
+        if (pinned.erase(id))
+            unpinned.push_back(id);
+    }
+
+    void EngineHack::release_result(JobID id)
+    {
+        std::unique_lock<std::mutex> lock(mutex_results);
+        freedResults.push_back(id);
+    }
+
+    void EngineHack::reset_results() noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex_results);
+        freedResults.clear();
+        resetResults = true;
+    }
+
+    void EngineHack::reset_state() noexcept
+    {
+        argCache.reset();
+
+        std::unique_lock<std::mutex> lock(mutex_templates);
+        pinned.clear();
+        unpinned.clear();
+        resetTemplates = true;
+    }
+
+    void EngineHack::apply_template(JobFuture &job, JobFuture::Spec &extra)
+    {
+        const auto &tmpl = job.get_template();
+        bool used = tmpl && !tmpl->fixedArgs.isEmpty();
+        bool released = used && tmpl->released;
+
+        std::unique_lock<std::mutex> lock(mutex_templates);
+        bool reset = resetTemplates;
+        resetTemplates = false;
+        std::vector<TemplateID> release;
+        release.swap(unpinned);
+        bool store = used && !released && pinned.insert(tmpl->id).second;
+        lock.unlock();
+
+        if (!used && !reset && release.empty())
+            return;
+
+        auto st = factory.createStructArray({ 1 }, { "id", "store", "fixed", "release", "reset" });
+        st[0]["id"] = used
+            ? factory.createScalar<TemplateID>(tmpl->id)
+            : factory.createArray<TemplateID>({ 0, 0 });
+        st[0]["store"] = factory.createScalar<bool>(store);
+        st[0]["fixed"] = store || released ? tmpl->fixedArgs : factory.createCellArray({ 0, 0 });
+        st[0]["release"] = factory.createArray({ 1, release.size() },
+            release.cbegin(), release.cend());
+        st[0]["reset"] = factory.createScalar<bool>(reset);
+        extra.emplace_back("template", std::move(st));
+    }
+
+    void EngineHack::apply_deps(JobFuture &job, JobFuture::Spec &extra)
+    {
+        const auto &inputs = job.get_storedInputs();
+        bool keep = job.get_keep() || job.is_resident();
+
+        std::unique_lock<std::mutex> lock(mutex_results);
+        bool reset = resetResults;
+        resetResults = false;
+        std::vector<JobID> release;
+        release.swap(freedResults);
+        lock.unlock();
+
+        if (inputs.empty() && !keep && !reset && release.empty())
+            return;
+
+        // the indices are one based
+        auto index = factory.createArray<std::uint64_t>({ 1, inputs.size() });
+        auto jobs = factory.createArray<JobID>({ 1, inputs.size() });
+        auto output = factory.createArray<std::uint64_t>({ 1, inputs.size() });
+        auto &args = job.get_args();
+        for (std::size_t i = 0; i < inputs.size(); i++)
+        {
+            index[i] = inputs[i].index + 1;
+            jobs[i] = inputs[i].job;
+            output[i] = inputs[i].output + 1;
+            args[inputs[i].index] = factory.createArray<double>({ 0, 0 });
+        }
+
+        auto st = factory.createStructArray({ 1 },
+            { "keep", "index", "job", "output", "release", "reset", "resident" });
+        st[0]["keep"] = keep
+            ? factory.createScalar<JobID>(job.get_ID())
+            : factory.createArray<JobID>({ 0, 0 });
+        st[0]["index"] = std::move(index);
+        st[0]["job"] = std::move(jobs);
+        st[0]["output"] = std::move(output);
+        st[0]["release"] = factory.createArray({ 1, release.size() },
+            release.cbegin(), release.cend());
+        st[0]["reset"] = factory.createScalar<bool>(reset);
+        // a resident job returns only the metadata of its return values
+        st[0]["resident"] = job.is_resident()
+            ? factory.createScalar<std::uint64_t>(job.get_nlhs())
+            : factory.createArray<std::uint64_t>({ 0, 0 });
+        extra.emplace_back("deps", std::move(st));
+    }
+
+    void EngineHack::apply_cache(JobFuture &job, JobFuture::Spec &extra)
+    {
+        auto &args = job.get_args();
+        bool reset = argCache.pop_reset();
+        bool used = false;
+
+        if (job.get_argDigests().empty() && !reset && !argCache.has_evicted())
+            return;
+
+        // empty keys are plain arguments
+        auto keys = factory.createCellArray({ 1, args.size() });
+        for (const auto &d : job.get_argDigests())
+        {
+            if (argCache.lookup(d.digest))
+            {
+                keys[d.index] = factory.createCharArray("R" + d.digest.to_string());
+                replaced.emplace_back(d.index, std::move(args[d.index]));
+                args[d.index] = factory.createArray<double>({ 0, 0 });
+                used = true;
+            }
+            else if (argCache.insert(d.digest, d.bytes))
+            {
+                keys[d.index] = factory.createCharArray("S" + d.digest.to_string());
+                used = true;
+            }
+        }
+
+        std::vector<Digest> evicted = argCache.pop_evicted();
+        if (!used && !reset && evicted.empty())
+            return;
+
+        auto evict = factory.createCellArray({ 1, evicted.size() });
+        for (std::size_t i = 0; i < evicted.size(); i++)
+            evict[i] = factory.createCharArray(evicted[i].to_string());
+
+        auto st = factory.createStructArray({ 1 }, { "keys", "evict", "reset" });
+        st[0]["keys"] = std::move(keys);
+        st[0]["evict"] = std::move(evict);
+        st[0]["reset"] = factory.createScalar<bool>(reset);
+        extra.emplace_back("cache", std::move(st));
+    }
+
+    std::unique_ptr<EngineHack::Resend> EngineHack::make_resend(JobFuture &job,
+        const JobFuture::Spec &extra)
+    {
+        const auto &args = job.get_args();
+        auto r = std::make_unique<Resend>();
+        r->engine = this;
+        r->nlhs = job.is_resident() ? 1 : job.get_nlhs();
+
+        // no cached arguments, the worker clears its cache
+        JobFuture::Spec tmp = extra;
+        for (auto &e : tmp)
+        {
+            if (e.first != "cache")
+                continue;
+            auto st = factory.createStructArray({ 1 }, { "keys", "evict", "reset" });
+            st[0]["keys"] = factory.createCellArray({ 1, args.size() });
+            st[0]["evict"] = factory.createCellArray({ 1, 0 });
+            st[0]["reset"] = factory.createScalar<bool>(true);
+            e.second = std::move(st);
+        }
+
+        const auto &tmpl = job.get_template();
+        r->args.reserve(2 + args.size());
+        r->args.push_back(create_spec(job.get_spec(), tmp));
+        r->args.push_back(tmpl ? tmpl->funArray : factory.createCharArray(job.get_cmd()));
+        r->args.insert(r->args.end(), args.begin(), args.end());
+        for (auto &e : replaced)
+            r->args[2 + e.first] = e.second;
+        r->outBuf = job.get_outBuf().get();
+        r->errBuf = job.get_errBuf().get();
+        return r;
+    }
+
+    bool EngineHack::resend(MatlabPromiseHack *p_hack) noexcept
+    {
+        using namespace matlab::execution;
+        using matlab::data::impl::ArrayImpl;
+
+        // a second miss fails the job
+        std::unique_ptr<Resend> r = std::move(p_hack->resend);
+        EngineHack *e = r->engine;
+        try
+        {
+            // the call resets the cache of the worker, so the record
+            // starts empty without a further reset
+            e->argCache.reset();
+            e->argCache.pop_reset();
+
+            std::vector<ArrayImpl *> impl;
+            impl.reserve(r->args.size());
+            for (auto &a : r->args)
+                impl.push_back(matlab::data::detail::Access::getImpl<ArrayImpl>(std::move(a)));
+
+            void *output = r->outBuf
+                ? slab_new<std::shared_ptr<StreamBuffer>>(std::move(r->outBuf))
+                : nullptr;
+            void *error = r->errBuf
+                ? slab_new<std::shared_ptr<StreamBuffer>>(std::move(r->errBuf))
+                : nullptr;
+
+            // the job can not be canceled any more, its task reference
+            // belongs to the first call
+            cpp_engine_feval_with_completion(
+                e->matlabHandle,
+                worker_dispatcher,
+                r->nlhs, false, impl.data(), impl.size(),
+                set_feval_promise_data_hack,
+                set_feval_promise_exception_hack,
+                p_hack, output, error,
+                &writeToStreamBuffer,
+                &delete_stream_buffer
+            );
+        }
+        catch (...)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    matlab::data::StructArray EngineHack::create_spec(const JobFuture::Spec &spec,
+        const JobFuture::Spec &extra)
+    {
+        std::vector<std::string> names;
+        names.reserve(spec.size() + extra.size());
+        for (const auto &e : extra)
+            names.push_back(e.first);
+        for (const auto &e : spec)
+            names.push_back(e.first);
+
+        auto st = factory.createStructArray({ 1 }, std::move(names));
+        for (const auto &e : extra)
+            st[0][e.first] = e.second;
+        for (const auto &e : spec)
+            st[0][e.first] = e.second;
+        return st;
+    }
+
     // this function is copied from:
     //   matlabroot/extern/include/MatlabEngine/detail/engine_factory_impl.hpp
     //   (Line 36)
@@ -99,16 +444,28 @@ namespace MatlabPool
         matlab::data::impl::ArrayImpl **plhs)
     {
         MatlabPromiseHack *p_hack = reinterpret_cast<MatlabPromiseHack *>(p);
+        MATLABPOOL_ASSERT(!straight);
 
-        // call the original function
-        matlab::execution::set_feval_promise_data(
-            p_hack->prom, nlhs, straight, plhs);
+        // like the original function, but the promise is a member of
+        // the MatlabPromiseHack object
+        try
+        {
+            Result result;
+            result.reserve(nlhs);
+            for (size_t i = 0; i < nlhs; i++)
+                result.push_back(matlab::data::detail::Access::createObj<matlab::data::Array>(plhs[i]));
+            p_hack->prom.set_value(std::move(result));
+        }
+        catch (...)
+        {
+            p_hack->prom.set_exception(std::current_exception());
+        }
 
         // call the notifier
         p_hack->notifier();
 
         // the MatlabPromiseHack object is no longer needed
-        delete p_hack;
+        slab_delete(p_hack);
     }
 
     void EngineHack::set_feval_promise_exception_hack(
@@ -117,14 +474,39 @@ namespace MatlabPool
     {
         MatlabPromiseHack *p_hack = reinterpret_cast<MatlabPromiseHack *>(p);
 
-        // call the original function
+        // the original function creates the exception and deletes the
+        // promise, so it gets a temporary promise (errors are not 
+        // part of the allocation free path)
+        auto *tmp = new std::promise<Result>();
+        std::future<Result> f = tmp->get_future();
         matlab::execution::set_feval_promise_exception(
-            p_hack->prom, nlhs, straight, excTypeNumber, msg);
+            tmp, nlhs, straight, excTypeNumber, msg);
+        try
+        {
+            f.get();
+        }
+        catch (const matlab::engine::MATLABException &e)
+        {
+            // the notifier is called at the end of the second call
+            if (p_hack->resend && e.getMessageID() == "MatlabPoolWorker:CacheMiss" &&
+                resend(p_hack))
+                return;
+            p_hack->prom.set_exception(std::current_exception());
+        }
+        catch (...)
+        {
+            p_hack->prom.set_exception(std::current_exception());
+        }
 
         // call the notifier
         p_hack->notifier();
 
         // the MatlabPromiseHack object is no longer needed
-        delete p_hack;
+        slab_delete(p_hack);
+    }
+
+    void EngineHack::delete_stream_buffer(void *impl)
+    {
+        slab_delete(static_cast<std::shared_ptr<matlab::execution::StreamBuffer> *>(impl));
     }
 } // namespace MatlabPool
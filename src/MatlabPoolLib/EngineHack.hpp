@@ -5,12 +5,18 @@
 #include "MatlabEngine.hpp"
 
 #include "MatlabPoolLib/JobFuture.hpp"
+#include "MatlabPoolLib/ArgumentCache.hpp"
+#include "MatlabPoolLib/Notifier.hpp"
+#include "MatlabPoolLib/CpuLayout.hpp"
 #include "MatlabPool/StreamBuf.hpp"
+#include "MatlabPool/SlabPool.hpp"
+
+#include <mutex>
+#include <set>
 
 namespace MatlabPool
 {
     using Future = matlab::execution::FutureResult<std::vector<matlab::data::Array>>;
-    using Notifier = std::function<void()>;
 
     // This class provides another function for job execution
     // on a matlab instance. This new functions works like the
@@ -23,23 +29,102 @@ namespace MatlabPool
         // This struct is needed to deliver the extra field
         // "notifier" to the "set_feval_promise_data_hack" 
         // and "set_feval_promise_exception_hack".
+        // Both objects are allocated by a "SlabPool".
+        using Result = std::vector<matlab::data::Array>;
+
+        // A job, whose arguments are replaced by cached copies, is 
+        // sent again with all arguments if the worker misses a copy
+        // (e.g. after "clear functions" on the worker).
+        struct Resend
+        {
+            EngineHack *engine;
+            std::size_t nlhs;
+            std::vector<matlab::data::Array> args; // spec, function, arguments
+            std::shared_ptr<matlab::execution::StreamBuffer> outBuf;
+            std::shared_ptr<matlab::execution::StreamBuffer> errBuf;
+        };
+
         struct MatlabPromiseHack
         {
-            std::promise<std::vector<matlab::data::Array>> *prom;
+            std::promise<Result> prom;
             Notifier notifier;
+            std::unique_ptr<Resend> resend; // jobs with cached arguments
         };
 
     public:
         EngineHack(const EngineHack &) = delete;
         EngineHack &operator=(const EngineHack &) = delete;
 
-        EngineHack(const std::vector<std::u16string> &options);
+        // a non-empty "cpus" binds the engine to the CPUs and sets
+        // "maxNumCompThreads" to the size of the set
+        EngineHack(const std::vector<std::u16string> &options,
+            const CpuSet &cpus = {});
 
         // like matlab::engine::MATLABEngine::fevalAsync, but
         // it also runs the notifier at the end of the job
         void eval_job(JobFuture &job, Notifier &&notifier);
 
+        // process id of the matlab session
+        std::uint64_t get_pid() const noexcept;
+
+        // resident memory of the matlab session in bytes, zero if it
+        // is unknown (only supported on linux)
+        std::size_t get_memory() const noexcept;
+
+        // bind the engine to other CPUs (an empty set releases the 
+        // binding), the caller must adjust "maxNumCompThreads" with 
+        // the next job
+        bool pin(const CpuSet &val) noexcept;
+
+        const CpuSet &get_cpus() const noexcept;
+
+        // record of the arguments which are cached by this worker
+        ArgumentCache &get_argumentCache() noexcept;
+
+        // remove the fixed arguments of a template from the worker
+        // (with the next job)
+        void unpin_template(TemplateID id);
+
+        // remove the stored return values of a job from the worker 
+        // (with the next job)
+        void release_result(JobID id);
+
+        // remove all stored return values (with the next job)
+        void reset_results() noexcept;
+
+        // forget the cached arguments and the pinned templates, the
+        // worker clears its state with the next job (e.g. a job was
+        // canceled before the worker stored its arguments)
+        void reset_state() noexcept;
+
     private:
+        // replace large arguments, which are already cached by the 
+        // worker, and add the field "cache" to the specification. The
+        // replaced arguments are kept in "replaced"
+        void apply_cache(JobFuture &job, JobFuture::Spec &extra);
+
+        // the call of a job with all arguments for the worker side 
+        // dispatcher, the worker clears its cache
+        std::unique_ptr<Resend> make_resend(JobFuture &job, const JobFuture::Spec &extra);
+
+        // evaluate the call of "make_resend" with the promise of the 
+        // first call, returns false if the call is not started
+        static bool resend(MatlabPromiseHack *p_hack) noexcept;
+
+        // add the field "template" to the specification, the fixed
+        // arguments are sent only if they are not pinned on the worker
+        void apply_template(JobFuture &job, JobFuture::Spec &extra);
+
+        // add the field "deps" to the specification: stored return 
+        // values, which replace arguments, and the job id if the 
+        // worker keeps the return values of this job (always for 
+        // worker-resident results)
+        void apply_deps(JobFuture &job, JobFuture::Spec &extra);
+
+        // create the struct for the worker side dispatcher
+        static matlab::data::StructArray create_spec(const JobFuture::Spec &spec,
+            const JobFuture::Spec &extra);
+
         // start a matlab session 
         std::future<uint64_t> start_matlabasync(
             const std::vector<std::u16string> &options);
@@ -59,6 +144,32 @@ namespace MatlabPool
         static void set_feval_promise_exception_hack(
             void *p, size_t nlhs, bool straight,
             size_t excTypeNumber, const void *msg);
+
+        // delete the copies of the output and error buffers
+        // original function: deleteStreamBufferImpl
+        static void delete_stream_buffer(void *impl);
+
+    private:
+        ArgumentCache argCache;
+        std::uint64_t pid;
+        CpuSet cpus;
+
+        std::set<TemplateID> pinned;            // mutex_templates
+        std::vector<TemplateID> unpinned;       // mutex_templates
+        bool resetTemplates;                    // mutex_templates
+        std::mutex mutex_templates;
+
+        std::vector<JobID> freedResults;        // mutex_results
+        bool resetResults;                      // mutex_results
+        std::mutex mutex_results;
+
+        // buffers of "eval_job", which are reused for every job
+        std::vector<matlab::data::impl::ArrayImpl *> argsImpl;
+        std::vector<matlab::data::Array> prefix;
+        std::vector<std::pair<std::size_t, matlab::data::Array>> replaced;
+        std::string funstrBuf;
+
+        inline static matlab::data::ArrayFactory factory;
     };
 } // namespace MatlabPool
 
@@ -0,0 +1,73 @@
+#include "MatlabPoolLib/GatherTarget.hpp"
+
+#include "MatlabPool/Assert.hpp"
+
+namespace MatlabPool
+{
+
+    GatherTarget::GatherTarget(matlab::data::Array output,
+        std::vector<Utilities::Slice> slices)
+        : output(std::move(output)),
+        slices(std::move(slices)),
+        used(this->slices.size(), false),
+        pending(0)
+    {
+        auto dims = this->output.getDimensions();
+        for (const auto &s : this->slices)
+            if (!Utilities::isInside(s, dims))
+                throw Pool::InvalidSlice();
+    }
+
+    void GatherTarget::add_job(std::size_t slot)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (slot >= slices.size() || used[slot])
+            throw Pool::InvalidSlice();
+        used[slot] = true;
+        ++pending;
+    }
+
+    void GatherTarget::set_result(std::size_t slot, const matlab::data::Array &result) noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        try
+        {
+            Utilities::copyToSlice(output, result, slices[slot]);
+        }
+        catch (...)
+        {
+            if (!error)
+                error = std::current_exception();
+        }
+        finish(slot);
+    }
+
+    void GatherTarget::set_error(std::size_t slot, std::exception_ptr val) noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!error)
+            error = val;
+        finish(slot);
+    }
+
+    matlab::data::Array GatherTarget::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (pending > 0)
+            cv.wait(lock);
+
+        if (error)
+            std::rethrow_exception(error);
+
+        return std::move(output);
+    }
+
+    void GatherTarget::finish(std::size_t slot) noexcept
+    {
+        MATLABPOOL_ASSERT(slot < slices.size() && used[slot] && pending > 0);
+        --pending;
+        if (pending == 0)
+            cv.notify_all();
+    }
+
+} // namespace MatlabPool
@@ -0,0 +1,59 @@
+#ifndef MATLABPOOL_GATHERTARGET_HPP
+#define MATLABPOOL_GATHERTARGET_HPP
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "MatlabPool/Pool.hpp"
+#include "MatlabPool/Utilities.hpp"
+
+#include "MatlabDataArray.hpp"
+
+namespace MatlabPool
+{
+    // A preallocated output array and a map of slices (slots). The
+    // result of a job is copied into its slot as soon as the job is
+    // finished, so the results are never stored all at once.
+    class GatherTarget
+    {
+    public:
+        GatherTarget(const GatherTarget &) = delete;
+        GatherTarget &operator=(const GatherTarget &) = delete;
+
+        GatherTarget(matlab::data::Array output,
+            std::vector<Utilities::Slice> slices);
+
+        // register a job for a slot, throws "Pool::InvalidSlice"
+        // if the slot does not exist or is already in use
+        void add_job(std::size_t slot);
+
+        // copy the (first) result of a job into its slot
+        void set_result(std::size_t slot, const matlab::data::Array &result) noexcept;
+
+        // the job of the slot is failed or canceled
+        void set_error(std::size_t slot, std::exception_ptr error) noexcept;
+
+        // wait until all registered jobs are finished, returns the 
+        // assembled array or throws the first error
+        matlab::data::Array wait();
+
+    private:
+        // a slot is finished, mutex must be locked
+        void finish(std::size_t slot) noexcept;
+
+    private:
+        matlab::data::Array output;         // mutex
+        std::vector<Utilities::Slice> slices;
+        std::vector<bool> used;             // mutex
+        std::size_t pending;                // mutex
+        std::exception_ptr error;           // mutex
+
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+} // namespace MatlabPool
+
+#endif
@@ -4,12 +4,29 @@
 
 namespace MatlabPool
 {
-    JobFuture::JobFuture() noexcept : JobFeval() {}
+    JobFuture::JobFuture() noexcept
+        : JobFeval(),
+        hasKey(false),
+        jobKey{ 0, 0 },
+        leaderID(0),
+        detached(false),
+        blocking(0),
+        parent(false),
+        keep(false),
+        resident(false),
+        hasActor(false),
+        actor(0),
+        affinity(-1),
+        expectedCost(0),
+        gatherSlot(0)
+    {
+    }
 
     JobFuture::JobFuture(JobFeval &&job) noexcept : JobFuture()
     {
         using std::swap;
         std::swap(static_cast<JobFeval &>(*this), job);
+        submitTime = std::chrono::steady_clock::now();
     }
 
     JobFuture::JobFuture(JobFuture &&other) noexcept : JobFuture()
@@ -28,6 +45,11 @@ namespace MatlabPool
     JobFuture::~JobFuture()
     {
         cancel();
+
+        // the job is removed before its result was gathered
+        if (gatherTarget)
+            gatherTarget->set_error(gatherSlot,
+                std::make_exception_ptr(Pool::JobNotExists(id)));
     }
 
     void swap(JobFuture &j1, JobFuture &j2) noexcept
@@ -35,6 +57,27 @@ namespace MatlabPool
         using std::swap;
         swap(static_cast<JobFeval &>(j1), static_cast<JobFeval &>(j2));
         swap(j1.future, j2.future);
+        swap(j1.submitTime, j2.submitTime);
+        swap(j1.spec, j2.spec);
+        swap(j1.argDigests, j2.argDigests);
+        swap(j1.hasKey, j2.hasKey);
+        swap(j1.jobKey, j2.jobKey);
+        swap(j1.followers, j2.followers);
+        swap(j1.leaderID, j2.leaderID);
+        swap(j1.detached, j2.detached);
+        swap(j1.jobTemplate, j2.jobTemplate);
+        swap(j1.dependencies, j2.dependencies);
+        swap(j1.blocking, j2.blocking);
+        swap(j1.parent, j2.parent);
+        swap(j1.keep, j2.keep);
+        swap(j1.resident, j2.resident);
+        swap(j1.hasActor, j2.hasActor);
+        swap(j1.actor, j2.actor);
+        swap(j1.affinity, j2.affinity);
+        swap(j1.expectedCost, j2.expectedCost);
+        swap(j1.storedInputs, j2.storedInputs);
+        swap(j1.gatherTarget, j2.gatherTarget);
+        swap(j1.gatherSlot, j2.gatherSlot);
     }
 
     void JobFuture::set_future(Future &&val) noexcept
@@ -42,8 +85,30 @@ namespace MatlabPool
         future = std::move(val);
     }
 
+    void JobFuture::set_result(Result &&val) noexcept
+    {
+        result = std::move(val);
+        status = Status::Done;
+        leaderID = 0;
+    }
+
+    void JobFuture::set_error(const std::u16string &msg)
+    {
+        errorBuf << msg;
+        status = Status::Error;
+        leaderID = 0;
+    }
+
+    std::chrono::steady_clock::time_point JobFuture::get_submitTime() const noexcept
+    {
+        return submitTime;
+    }
+
     void JobFuture::wait() noexcept
     {
+        if (!future.valid())
+            return; // finished without a worker or already waited
+
         try
         {
             result = future.get();
@@ -83,4 +148,260 @@ namespace MatlabPool
         }
     }
 
+    void JobFuture::add_spec(std::string name, matlab::data::Array val)
+    {
+        spec.emplace_back(std::move(name), std::move(val));
+    }
+
+    const JobFuture::Spec &JobFuture::get_spec() const noexcept
+    {
+        return spec;
+    }
+
+    void JobFuture::hash_args(std::size_t threshold)
+    {
+        argDigests.clear();
+        for (std::size_t i = 0; i < args.size(); i++)
+        {
+            std::size_t bytes = Serializer::get_bytes(args[i]);
+            if (bytes < threshold)
+                continue;
+
+            try
+            {
+                Hasher hasher;
+                Serializer::write(hasher, args[i]);
+                argDigests.push_back({ i, hasher.get_digest(), bytes });
+            }
+            catch (const Utilities::UnsupportedType &)
+            {
+                // e.g. a cell with an object, the argument is not cached
+            }
+        }
+    }
+
+    const std::vector<JobFuture::ArgDigest> &JobFuture::get_argDigests() const noexcept
+    {
+        return argDigests;
+    }
+
+    void JobFuture::set_jobKey(const Digest &key) noexcept
+    {
+        hasKey = true;
+        jobKey = key;
+    }
+
+    bool JobFuture::has_jobKey() const noexcept
+    {
+        return hasKey;
+    }
+
+    const Digest &JobFuture::get_jobKey() const noexcept
+    {
+        return jobKey;
+    }
+
+    void JobFuture::add_follower(JobID follower)
+    {
+        followers.push_back(follower);
+    }
+
+    bool JobFuture::has_followers() const noexcept
+    {
+        return !followers.empty();
+    }
+
+    std::vector<JobID> JobFuture::pop_followers() noexcept
+    {
+        std::vector<JobID> tmp;
+        tmp.swap(followers);
+        return tmp;
+    }
+
+    void JobFuture::set_leader(JobID leader) noexcept
+    {
+        leaderID = leader;
+        status = Status::InProgress;
+    }
+
+    bool JobFuture::is_pending() const noexcept
+    {
+        return leaderID != 0;
+    }
+
+    void JobFuture::share_result(JobFuture &leader)
+    {
+        MATLABPOOL_ASSERT(leader.get_ID() == leaderID);
+        outputBuf << leader.outputBuf.str();
+        errorBuf << leader.errorBuf.str();
+        result = leader.result;
+        status = leader.status;
+        leaderID = 0;
+    }
+
+    void JobFuture::adopt_result(JobFuture &copy)
+    {
+        if (future.valid())
+        {
+            future.cancel();
+            future = Future();
+        }
+        outputBuf << copy.outputBuf.str();
+        errorBuf << copy.errorBuf.str();
+        result = copy.result;
+        status = copy.status;
+    }
+
+    void JobFuture::set_detached() noexcept
+    {
+        detached = true;
+    }
+
+    bool JobFuture::is_detached() const noexcept
+    {
+        return detached;
+    }
+
+    void JobFuture::set_template(std::shared_ptr<const JobTemplate> val) noexcept
+    {
+        jobTemplate = std::move(val);
+    }
+
+    const std::shared_ptr<const JobTemplate> &JobFuture::get_template() const noexcept
+    {
+        return jobTemplate;
+    }
+
+    const std::u16string &JobFuture::get_cmd() const noexcept
+    {
+        return jobTemplate ? jobTemplate->fun : JobFeval::get_cmd();
+    }
+
+    void JobFuture::set_dependencies(std::vector<JobDependency> &&val) noexcept
+    {
+        dependencies = std::move(val);
+    }
+
+    const std::vector<JobDependency> &JobFuture::get_dependencies() const noexcept
+    {
+        return dependencies;
+    }
+
+    void JobFuture::set_blocking(std::size_t val) noexcept
+    {
+        blocking = val;
+    }
+
+    bool JobFuture::unblock() noexcept
+    {
+        MATLABPOOL_ASSERT(blocking > 0);
+        return --blocking == 0;
+    }
+
+    void JobFuture::set_parent() noexcept
+    {
+        parent = true;
+    }
+
+    bool JobFuture::is_parent() const noexcept
+    {
+        return parent;
+    }
+
+    void JobFuture::set_keep(bool val) noexcept
+    {
+        keep = val;
+    }
+
+    bool JobFuture::get_keep() const noexcept
+    {
+        return keep;
+    }
+
+    void JobFuture::set_resident() noexcept
+    {
+        resident = true;
+    }
+
+    bool JobFuture::is_resident() const noexcept
+    {
+        return resident;
+    }
+
+    void JobFuture::set_actor(ActorID id) noexcept
+    {
+        hasActor = true;
+        actor = id;
+    }
+
+    bool JobFuture::has_actor() const noexcept
+    {
+        return hasActor;
+    }
+
+    ActorID JobFuture::get_actor() const noexcept
+    {
+        return actor;
+    }
+
+    void JobFuture::set_affinity(int workerID) noexcept
+    {
+        affinity = workerID;
+    }
+
+    int JobFuture::get_affinity() const noexcept
+    {
+        return affinity;
+    }
+
+    void JobFuture::set_expectedCost(double val) noexcept
+    {
+        expectedCost = val;
+    }
+
+    double JobFuture::get_expectedCost() const noexcept
+    {
+        return expectedCost;
+    }
+
+    void JobFuture::add_storedInput(const StoredInput &val)
+    {
+        storedInputs.push_back(val);
+    }
+
+    const std::vector<JobFuture::StoredInput> &JobFuture::get_storedInputs() const noexcept
+    {
+        return storedInputs;
+    }
+
+    void JobFuture::set_gather(std::shared_ptr<GatherTarget> target, std::size_t slot) noexcept
+    {
+        gatherTarget = std::move(target);
+        gatherSlot = slot;
+    }
+
+    bool JobFuture::has_gather() const noexcept
+    {
+        return bool(gatherTarget);
+    }
+
+    void JobFuture::gather() noexcept
+    {
+        MATLABPOOL_ASSERT(gatherTarget != nullptr);
+        wait();
+
+        if (status == Status::Done && !result.empty())
+            gatherTarget->set_result(gatherSlot, result[0]);
+        else if (status == Status::Done)
+            gatherTarget->set_error(gatherSlot,
+                std::make_exception_ptr(NoResults()));
+        else
+            gatherTarget->set_error(gatherSlot,
+                std::make_exception_ptr(ExecutionError(id, errorBuf)));
+
+        result.clear();
+        status = Status::DoneEmpty;
+        gatherTarget.reset();
+    }
+
 } // namespace MatlabPool
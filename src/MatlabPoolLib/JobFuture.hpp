@@ -2,6 +2,9 @@
 #define MATLABPOOL_JOBFUTURE_HPP
 
 #include "MatlabPool/JobFeval.hpp"
+#include "MatlabPool/Serializer.hpp"
+#include "MatlabPoolLib/GatherTarget.hpp"
+#include "MatlabPoolLib/JobTemplate.hpp"
 
 #include "MatlabEngine.hpp"
 
@@ -17,6 +20,27 @@ namespace MatlabPool
         using Result = std::vector<matlab::data::Array>;
         using Future = matlab::engine::FutureResult<Result>;
 
+    public:
+        // fields of the struct for the worker side dispatcher
+        using Spec = std::vector<std::pair<std::string, matlab::data::Array>>;
+
+        // argument which is replaced by a return value stored by the
+        // worker, see "MatlabPoolWorker.job_results"
+        struct StoredInput
+        {
+            std::size_t index;
+            JobID job;
+            std::size_t output;
+        };
+
+        // hash of a large argument, see "ArgumentCache"
+        struct ArgDigest
+        {
+            std::size_t index;
+            Digest digest;
+            std::size_t bytes;
+        };
+
     public:
         JobFuture(const JobFuture &other) = delete;
         JobFuture &operator=(const JobFuture &other) = delete;
@@ -32,6 +56,16 @@ namespace MatlabPool
         // set results of the jobs
         void set_future(Future &&val) noexcept;
 
+        // the job is finished without a worker, e.g. the results are
+        // served by the result cache
+        void set_result(Result &&val) noexcept;
+
+        // the job is failed without a worker, e.g. a job of a batch
+        void set_error(const std::u16string &msg);
+
+        // time of the construction, i.e. the submission of the job
+        std::chrono::steady_clock::time_point get_submitTime() const noexcept;
+
         // wait until the job is done
         void wait() noexcept;
 
@@ -40,8 +74,159 @@ namespace MatlabPool
 
         Status get_status() const noexcept;
 
+        // add a field to the specification for the worker side
+        // dispatcher "MatlabPoolWorker.run". Jobs with an empty
+        // specification are evaluated directly by the worker
+        void add_spec(std::string name, matlab::data::Array val);
+
+        const Spec &get_spec() const noexcept;
+
+        // compute the hash of all arguments with at least "threshold"
+        // bytes
+        void hash_args(std::size_t threshold);
+
+        const std::vector<ArgDigest> &get_argDigests() const noexcept;
+
+        // hash of the function and the arguments, used by the result
+        // cache and for the coalescing of identical jobs (see 
+        // "ResultCache::get_key")
+        void set_jobKey(const Digest &key) noexcept;
+
+        bool has_jobKey() const noexcept;
+
+        const Digest &get_jobKey() const noexcept;
+
+        // identical jobs share a single execution: the first job (the
+        // leader) is evaluated and its followers get a copy of the
+        // results
+        void add_follower(JobID follower);
+
+        bool has_followers() const noexcept;
+
+        // remove the list of followers
+        std::vector<JobID> pop_followers() noexcept;
+
+        // the job waits for the results of "leader"
+        void set_leader(JobID leader) noexcept;
+
+        // the job is a follower and its leader is not finished
+        bool is_pending() const noexcept;
+
+        // copy the results, the status and the buffers of the leader,
+        // the leader must be finished
+        void share_result(JobFuture &leader);
+
+        // the results, the status and the buffers of a finished
+        // speculative copy replace the results of this job, the 
+        // evaluation of this job is canceled
+        void adopt_result(JobFuture &copy);
+
+        // a canceled leader is not canceled as long as it has 
+        // followers, but it is not visible anymore
+        void set_detached() noexcept;
+
+        bool is_detached() const noexcept;
+
+        // the job is a job of a template, the fixed arguments of the 
+        // template are appended by the worker
+        void set_template(std::shared_ptr<const JobTemplate> val) noexcept;
+
+        const std::shared_ptr<const JobTemplate> &get_template() const noexcept;
+
+        // name of the function, a job of a template does not copy the 
+        // name and refers to the function of the template
+        const std::u16string &get_cmd() const noexcept;
+
+        // job graph: the job waits for the results of other jobs
+        void set_dependencies(std::vector<JobDependency> &&val) noexcept;
+
+        const std::vector<JobDependency> &get_dependencies() const noexcept;
+
+        // count of unfinished dependencies, "unblock" returns true if
+        // the last dependency is finished
+        void set_blocking(std::size_t val) noexcept;
+
+        bool unblock() noexcept;
+
+        // other jobs depend on this job (these jobs are not batched)
+        void set_parent() noexcept;
+
+        bool is_parent() const noexcept;
+
+        // the worker keeps the return values of this job for other
+        // jobs of the graph
+        void set_keep(bool val) noexcept;
+
+        bool get_keep() const noexcept;
+
+        // the return values stay on the worker, see 
+        // "Pool::submit_resident"
+        void set_resident() noexcept;
+
+        bool is_resident() const noexcept;
+
+        // the job is evaluated on the worker of an actor, see 
+        // "Pool::create_actor"
+        void set_actor(ActorID id) noexcept;
+
+        bool has_actor() const noexcept;
+
+        ActorID get_actor() const noexcept;
+
+        // preferred worker, e.g. the worker which holds the results of
+        // the dependencies (-1 for any worker)
+        void set_affinity(int workerID) noexcept;
+
+        int get_affinity() const noexcept;
+
+        // expected runtime of the job, set by the scheduler at the
+        // submission (see "LongestFirstScheduler")
+        void set_expectedCost(double val) noexcept;
+
+        double get_expectedCost() const noexcept;
+
+        // arguments which are taken from the results stored by the
+        // assigned worker
+        void add_storedInput(const StoredInput &val);
+
+        const std::vector<StoredInput> &get_storedInputs() const noexcept;
+
+        // the (first) result of the job is copied into a slot of
+        // the gather target
+        void set_gather(std::shared_ptr<GatherTarget> target, std::size_t slot) noexcept;
+
+        bool has_gather() const noexcept;
+
+        // wait until the job is done, copy the result into the gather
+        // target and free the result
+        void gather() noexcept;
+
     private:
         Future future;
+        std::chrono::steady_clock::time_point submitTime;
+        Spec spec;
+        std::vector<ArgDigest> argDigests;
+        bool hasKey;
+        Digest jobKey;
+        std::vector<JobID> followers;
+        JobID leaderID;
+        bool detached;
+
+        std::shared_ptr<const JobTemplate> jobTemplate;
+
+        std::vector<JobDependency> dependencies;
+        std::size_t blocking;
+        bool parent;
+        bool keep;
+        bool resident;
+        bool hasActor;
+        ActorID actor;
+        int affinity;
+        double expectedCost;
+        std::vector<StoredInput> storedInputs;
+
+        std::shared_ptr<GatherTarget> gatherTarget;
+        std::size_t gatherSlot;
     };
 
 } // namespace MatlabPool
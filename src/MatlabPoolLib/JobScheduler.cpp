@@ -0,0 +1,157 @@
+#include "MatlabPoolLib/JobScheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace MatlabPool
+{
+    std::unique_ptr<JobScheduler> JobScheduler::create(Pool::Scheduler type, std::size_t n,
+        const CostModel &costs)
+    {
+        if (type == Pool::Scheduler::WorkStealing)
+            return std::make_unique<StealingScheduler>(n);
+        if (type == Pool::Scheduler::LongestFirst)
+            return std::make_unique<LongestFirstScheduler>(costs);
+        return std::make_unique<CentralScheduler>();
+    }
+
+    bool JobScheduler::empty() const noexcept
+    {
+        for (const auto &queue : queues)
+            if (!queue.empty())
+                return false;
+        return true;
+    }
+
+    std::deque<JobScheduler::JobQueue> &JobScheduler::get_queues() noexcept
+    {
+        return queues;
+    }
+
+    CentralScheduler::CentralScheduler()
+    {
+        queues.resize(1);
+    }
+
+    void CentralScheduler::resize(std::size_t)
+    {
+    }
+
+    void CentralScheduler::push(JobFuture &&job)
+    {
+        queues[0].push_back(std::move(job));
+    }
+
+    JobScheduler::JobQueue &CentralScheduler::select(std::size_t)
+    {
+        return queues[0];
+    }
+
+    std::size_t CentralScheduler::pick(const JobQueue &queue, std::size_t workerID) const
+    {
+        // jobs without affinity, e.g. all jobs without a graph
+        int front = queue.front().get_affinity();
+        if (front < 0 || std::size_t(front) == workerID)
+            return 0;
+
+        std::size_t n = std::min(queue.size(), affinity_lookahead);
+        for (std::size_t i = 1; i < n; i++)
+            if (queue[i].get_affinity() == int(workerID))
+                return i;
+        for (std::size_t i = 1; i < n; i++)
+            if (queue[i].get_affinity() < 0)
+                return i;
+        return 0;
+    }
+
+    StealingScheduler::StealingScheduler(std::size_t n)
+        : nof_worker(std::max<std::size_t>(n, 1)),
+        next(0)
+    {
+        queues.resize(nof_worker);
+    }
+
+    void StealingScheduler::resize(std::size_t n)
+    {
+        n = std::max<std::size_t>(n, 1);
+        if (queues.size() < n)
+            queues.resize(n);
+
+        std::size_t n_old = nof_worker;
+        nof_worker = n;
+        for (std::size_t i = n; i < n_old; i++)
+        {
+            JobQueue tmp;
+            tmp.swap(queues[i]);
+            for (auto &job : tmp)
+                push(std::move(job));
+        }
+    }
+
+    void StealingScheduler::push(JobFuture &&job)
+    {
+        int affinity = job.get_affinity();
+        std::size_t workerID;
+        if (affinity >= 0 && std::size_t(affinity) < nof_worker)
+            workerID = std::size_t(affinity);
+        else
+            workerID = next++ % nof_worker;
+        queues[workerID].push_back(std::move(job));
+    }
+
+    JobScheduler::JobQueue &StealingScheduler::select(std::size_t workerID)
+    {
+        if (workerID < nof_worker && !queues[workerID].empty())
+            return queues[workerID];
+
+        // steal from the longest queue
+        std::size_t victim = 0;
+        for (std::size_t i = 1; i < nof_worker; i++)
+            if (queues[i].size() > queues[victim].size())
+                victim = i;
+        return queues[victim];
+    }
+
+    std::size_t StealingScheduler::pick(const JobQueue &queue, std::size_t workerID) const
+    {
+        if (workerID < nof_worker && &queue == &queues[workerID])
+            return 0;
+        return queue.size() - 1;
+    }
+
+    LongestFirstScheduler::LongestFirstScheduler(const CostModel &costs)
+        : costs(costs)
+    {
+        queues.resize(1);
+    }
+
+    void LongestFirstScheduler::resize(std::size_t)
+    {
+    }
+
+    void LongestFirstScheduler::push(JobFuture &&job)
+    {
+        double cost = job.get_cost();
+        if (cost <= 0)
+            cost = costs.estimate(job.get_cmd(), CostModel::get_bytes(job));
+        if (cost == CostModel::unknown)
+            cost = std::numeric_limits<double>::infinity();
+        job.set_expectedCost(cost);
+
+        JobQueue &queue = queues[0];
+        auto it = std::upper_bound(queue.begin(), queue.end(), cost,
+            [](double val, const JobFuture &e) { return val > e.get_expectedCost(); });
+        queue.insert(it, std::move(job));
+    }
+
+    JobScheduler::JobQueue &LongestFirstScheduler::select(std::size_t)
+    {
+        return queues[0];
+    }
+
+    std::size_t LongestFirstScheduler::pick(const JobQueue &, std::size_t) const
+    {
+        return 0;
+    }
+
+} // namespace MatlabPool
@@ -0,0 +1,117 @@
+#ifndef MATLABPOOL_JOBSCHEDULER_HPP
+#define MATLABPOOL_JOBSCHEDULER_HPP
+
+#include "MatlabPoolLib/CostModel.hpp"
+#include "MatlabPoolLib/JobFuture.hpp"
+#include "MatlabPool/SlabPool.hpp"
+
+#include <deque>
+#include <memory>
+
+namespace MatlabPool
+{
+    // Queues of the jobs which are not assigned to a worker yet. The 
+    // master thread asks the scheduler for the next job of a free 
+    // worker, the derived classes decide where a new job is queued and
+    // which queued job a worker takes. The scheduler is not thread 
+    // safe, "PoolImpl" locks mutex_jobs.
+    class JobScheduler
+    {
+    public:
+        // the nodes of the queues are allocated by a "SlabPool"
+        using JobQueue = std::deque<JobFuture, SlabAllocator<JobFuture>>;
+
+        JobScheduler(const JobScheduler &) = delete;
+        JobScheduler &operator=(const JobScheduler &) = delete;
+
+        JobScheduler() = default;
+        virtual ~JobScheduler() = default;
+
+        // create a scheduler for "n" workers, the runtime model must
+        // outlive the scheduler
+        static std::unique_ptr<JobScheduler> create(Pool::Scheduler type, std::size_t n,
+            const CostModel &costs);
+
+        // number of workers, the jobs of removed workers are queued 
+        // again
+        virtual void resize(std::size_t n) = 0;
+
+        virtual void push(JobFuture &&job) = 0;
+
+        // the queue with the next job of a free worker, the queue is
+        // empty if there is no job
+        virtual JobQueue &select(std::size_t workerID) = 0;
+
+        // index of the next job of a worker in the selected queue
+        virtual std::size_t pick(const JobQueue &queue, std::size_t workerID) const = 0;
+
+        bool empty() const noexcept;
+
+        // all queues, e.g. to search a job. The queues are never 
+        // removed, so the references stay valid
+        std::deque<JobQueue> &get_queues() noexcept;
+
+    protected:
+        std::deque<JobQueue> queues;
+    };
+
+    // A single queue for all workers (first in, first out). A job with
+    // an affinity (see "JobFuture::set_affinity") is preferred by its
+    // worker, if it is close to the front of the queue.
+    class CentralScheduler : public JobScheduler
+    {
+    public:
+        CentralScheduler();
+
+        void resize(std::size_t n) override;
+        void push(JobFuture &&job) override;
+        JobQueue &select(std::size_t workerID) override;
+        std::size_t pick(const JobQueue &queue, std::size_t workerID) const override;
+
+    private:
+        // number of queued jobs which are checked for their affinity
+        static constexpr std::size_t affinity_lookahead = 16;
+    };
+
+    // A queue for each worker. New jobs are queued for the worker of
+    // their affinity or round-robin. A worker takes the jobs from the 
+    // front of its own queue, an idle worker steals from the back of
+    // the longest queue.
+    class StealingScheduler : public JobScheduler
+    {
+    public:
+        StealingScheduler(std::size_t n);
+
+        void resize(std::size_t n) override;
+        void push(JobFuture &&job) override;
+        JobQueue &select(std::size_t workerID) override;
+        std::size_t pick(const JobQueue &queue, std::size_t workerID) const override;
+
+    private:
+        std::size_t nof_worker;
+        std::size_t next;   // round-robin
+    };
+
+    // A single queue for all workers, ordered by the expected runtime
+    // of the jobs (longest expected processing time first). The 
+    // runtime is estimated at the submission by the cost hint of the
+    // job or by the runtime model. Jobs without an estimate are taken
+    // first, so the model learns their runtime. Jobs with the same 
+    // estimate stay in the order of the submission.
+    class LongestFirstScheduler : public JobScheduler
+    {
+    public:
+        LongestFirstScheduler(const CostModel &costs);
+
+        void resize(std::size_t n) override;
+        void push(JobFuture &&job) override;
+        JobQueue &select(std::size_t workerID) override;
+        std::size_t pick(const JobQueue &queue, std::size_t workerID) const override;
+
+    private:
+        const CostModel &costs;
+    };
+
+} // namespace MatlabPool
+
+#endif
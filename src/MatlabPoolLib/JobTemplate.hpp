@@ -0,0 +1,37 @@
+#ifndef MATLABPOOL_JOBTEMPLATE_HPP
+#define MATLABPOOL_JOBTEMPLATE_HPP
+
+#include "MatlabPool/Pool.hpp"
+
+#include "MatlabDataArray.hpp"
+
+#include <atomic>
+#include <string>
+
+namespace MatlabPool
+{
+    // function and fixed arguments of a job template (see 
+    // "Pool::register_template"). The name of the function is 
+    // converted once, so the jobs of a template skip the string
+    // conversion during the dispatch.
+    struct JobTemplate
+    {
+        TemplateID id;
+        std::u16string fun;
+        std::size_t nlhs;
+
+        // name for the engine and for the worker side dispatcher
+        std::string funAscii;
+        matlab::data::CharArray funArray;
+
+        // cell array of the fixed arguments
+        matlab::data::CellArray fixedArgs;
+
+        // the template is unregistered, its remaining jobs send the
+        // fixed arguments without pinning them on the worker
+        mutable std::atomic<bool> released{ false };
+    };
+
+} // namespace MatlabPool
+
+#endif
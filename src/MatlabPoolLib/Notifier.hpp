@@ -0,0 +1,110 @@
+#ifndef MATLABPOOL_NOTIFIER_HPP
+#define MATLABPOOL_NOTIFIER_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace MatlabPool
+{
+    // Function object which is called at the end of a job. It works
+    // like a std::function<void()>, but the callable object is always
+    // stored inside the Notifier, so the construction never allocates
+    // memory. Callable objects which do not fit are rejected at
+    // compile time.
+    class Notifier
+    {
+        static constexpr std::size_t capacity = 6 * sizeof(void *);
+        using Storage = std::aligned_storage_t<capacity, alignof(std::max_align_t)>;
+
+        struct VTable
+        {
+            void (*call)(void *obj);
+            void (*move)(void *dst, void *src) noexcept;
+            void (*destroy)(void *obj) noexcept;
+        };
+
+        template <typename F>
+        static constexpr VTable vtable_for = {
+            [](void *obj) { (*static_cast<F *>(obj))(); },
+            [](void *dst, void *src) noexcept {
+                new (dst) F(std::move(*static_cast<F *>(src)));
+            },
+            [](void *obj) noexcept { static_cast<F *>(obj)->~F(); }
+        };
+
+    public:
+        Notifier(const Notifier &) = delete;
+        Notifier &operator=(const Notifier &) = delete;
+
+        Notifier() noexcept : vtable(nullptr) {}
+
+        template <typename F, typename = std::enable_if_t<
+            !std::is_same<std::decay_t<F>, Notifier>::value>>
+        Notifier(F &&fun) noexcept : vtable(&vtable_for<std::decay_t<F>>)
+        {
+            using T = std::decay_t<F>;
+            static_assert(sizeof(T) <= capacity, "the callable object is too large");
+            static_assert(alignof(T) <= alignof(Storage), "the callable object is over-aligned");
+            static_assert(std::is_nothrow_move_constructible<T>::value,
+                "the callable object must be nothrow move constructible");
+            new (&storage) T(std::forward<F>(fun));
+        }
+
+        Notifier(Notifier &&other) noexcept : vtable(other.vtable)
+        {
+            if (vtable)
+            {
+                vtable->move(&storage, &other.storage);
+                other.reset();
+            }
+        }
+
+        Notifier &operator=(Notifier &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                vtable = other.vtable;
+                if (vtable)
+                {
+                    vtable->move(&storage, &other.storage);
+                    other.reset();
+                }
+            }
+            return *this;
+        }
+
+        ~Notifier()
+        {
+            reset();
+        }
+
+        void operator()()
+        {
+            if (vtable)
+                vtable->call(&storage);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return vtable != nullptr;
+        }
+
+    private:
+        void reset() noexcept
+        {
+            if (vtable)
+                vtable->destroy(&storage);
+            vtable = nullptr;
+        }
+
+    private:
+        const VTable *vtable;
+        Storage storage;
+    };
+
+} // namespace MatlabPool
+
+#endif
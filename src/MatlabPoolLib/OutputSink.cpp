@@ -0,0 +1,62 @@
+#include "MatlabPoolLib/OutputSink.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace MatlabPool
+{
+
+    OutputSink::OutputSink(matlab::data::ArrayType type, std::vector<std::size_t> dims)
+        : type(type),
+        dims(std::move(dims)),
+        memory(get_bytes(type, this->dims))
+    {
+    }
+
+    matlab::data::StructArray OutputSink::add_slice(JobID id, const Utilities::Slice &slice)
+    {
+        if (!Utilities::isInside(slice, dims))
+            throw Pool::InvalidSlice();
+
+        auto st = factory.createStructArray({ 1 },
+            { "file", "class", "dims", "offset", "size" });
+        st[0]["file"] = factory.createCharArray(memory.get_path());
+        st[0]["class"] = factory.createCharArray(Utilities::get_className(type));
+        st[0]["dims"] = factory.createArray({ 1, dims.size() },
+            dims.begin(), dims.end());
+        st[0]["offset"] = factory.createArray({ 1, dims.size() },
+            slice.offset.begin(), slice.offset.end());
+        st[0]["size"] = factory.createArray({ 1, dims.size() },
+            slice.dims.begin(), slice.dims.end());
+
+        jobs.push_back(id);
+        return st;
+    }
+
+    const std::vector<JobID> &OutputSink::get_jobs() const noexcept
+    {
+        return jobs;
+    }
+
+    matlab::data::Array OutputSink::to_array() const
+    {
+        return Utilities::visitNumeric(type, [&](auto *p) -> matlab::data::Array {
+            using T = std::remove_pointer_t<decltype(p)>;
+            auto buffer = factory.createBuffer<T>(memory.size() / sizeof(T));
+            std::memcpy(buffer.get(), memory.data(), memory.size());
+            return factory.createArrayFromBuffer<T>(dims, std::move(buffer));
+        });
+    }
+
+    std::size_t OutputSink::get_bytes(matlab::data::ArrayType type,
+        const std::vector<std::size_t> &dims)
+    {
+        std::size_t n = Utilities::visitNumeric(type, [](auto *p) {
+            return sizeof(*p);
+        });
+        for (auto d : dims)
+            n *= d;
+        return n;
+    }
+
+} // namespace MatlabPool
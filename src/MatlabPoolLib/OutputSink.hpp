@@ -0,0 +1,52 @@
+#ifndef MATLABPOOL_OUTPUTSINK_HPP
+#define MATLABPOOL_OUTPUTSINK_HPP
+
+#include <vector>
+
+#include "MatlabPool/Pool.hpp"
+#include "MatlabPool/SharedMemory.hpp"
+#include "MatlabPool/Utilities.hpp"
+
+#include "MatlabDataArray.hpp"
+
+namespace MatlabPool
+{
+    // An output array in shared memory. Every job of the sink
+    // writes its result directly into a slice of this array (see
+    // "MatlabPoolWorker.write_sink"), so the results are neither
+    // sent back to the client nor merged afterwards.
+    class OutputSink
+    {
+    public:
+        OutputSink(const OutputSink &) = delete;
+        OutputSink &operator=(const OutputSink &) = delete;
+
+        OutputSink(matlab::data::ArrayType type, std::vector<std::size_t> dims);
+
+        // register the slice of a job, returns the description of
+        // the slice for the worker side. Throws "Pool::InvalidSlice"
+        // if the slice does not fit into the sink
+        matlab::data::StructArray add_slice(JobID id, const Utilities::Slice &slice);
+
+        // jobs which write into this sink
+        const std::vector<JobID> &get_jobs() const noexcept;
+
+        // copy the shared memory into a matlab array
+        matlab::data::Array to_array() const;
+
+    private:
+        static std::size_t get_bytes(matlab::data::ArrayType type,
+            const std::vector<std::size_t> &dims);
+
+    private:
+        matlab::data::ArrayType type;
+        std::vector<std::size_t> dims;
+        SharedMemory memory;
+        std::vector<JobID> jobs;
+
+        inline static matlab::data::ArrayFactory factory;
+    };
+
+} // namespace MatlabPool
+
+#endif
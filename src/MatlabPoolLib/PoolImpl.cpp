@@ -6,13 +6,47 @@ namespace MatlabPool
         : stop(false),
         sleep(false),
         worker_ready(n, false),
-        engine(n)
+        engine(n),
+        coalesce(false),
+        batch_size(0),
+        batch_window(0),
+        output_limit(StreamBuf::default_limit),
+        cache_threshold(1 << 20),
+        cache_capacity(256 << 20),
+        pinning(false),
+        pin_cpus(0),
+        pin_numa(false),
+        engineOptions(options),
+        scale_ups(0),
+        scale_downs(0),
+        recycle_jobs(0),
+        recycle_memory(0),
+        recycled(0),
+        passed_results(0),
+        scheduler(JobScheduler::create(Scheduler::Central, n, costs)),
+        speculation(0.0),
+        running(n),
+        served(n, 0),
+        lanes(1),
+        lane_pending(0),
+        speculation_count(0),
+        speculation_wins(0),
+        workerQueue(n),
+        pinned_pending(0),
+        broadcast_count(1),
+        distributed_count(1),
+        actor_count(1),
+        sink_count(1),
+        gather_count(1),
+        template_count(1)
     {
         if (n == 0)
             throw EmptyPool();
 
-        for (auto &e : engine)
-            e = std::make_unique<EngineHack>(options);
+        lanes[0].name = u"default";
+
+        for (std::size_t i = 0; i < n; i++)
+            engine[i] = start_engine(options, i);
 
         worker_ready.flip();
 
@@ -20,52 +54,94 @@ namespace MatlabPool
             for (;;)
             {
                 std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
-                while ((!stop && jobQueue.empty()) || sleep)
-                    cv_queue.wait(lock_jobs);
+                while ((!stop && !has_lane_jobs() && pinned_pending == 0) || sleep)
+                {
+                    // idle workers evaluate copies of slow jobs
+                    auto next = sleep ? std::chrono::steady_clock::time_point::max() : speculate();
+                    if (next == std::chrono::steady_clock::time_point::max())
+                        cv_queue.wait(lock_jobs);
+                    else
+                        cv_queue.wait_until(lock_jobs, next);
+                }
 
                 if (stop)
                     break;
 
+                // wait for more jobs of the same function before a
+                // worker is reserved, so no worker idles in the window
+                if (batch_size > 1)
+                {
+                    wait_batch(lock_jobs);
+                    if (stop || sleep)
+                        continue;
+                }
+
                 std::size_t workerID;
                 MatlabPool::EngineHack *worker;
 
+                // workers with pinned jobs, e.g. broadcast jobs
+                bool any = has_lane_jobs();
+                preferred.resize(workerQueue.size());
+                for (std::size_t i = 0; i < workerQueue.size(); i++)
+                    preferred[i] = !workerQueue[i].empty();
+
                 // wait for next free worker
-                lock_jobs.unlock(); // do not block adding new jobs
                 {
                     std::unique_lock<std::mutex> lock_worker(mutex_worker);
-                    workerID = get_free_worker(lock_worker);
+                    lock_jobs.unlock(); // do not block adding new jobs
+                    workerID = get_free_worker(lock_worker, any);
+                    if (workerID == no_worker)
+                        continue;
                     worker_ready[workerID] = false;
                     worker = engine[workerID].get();
                 }
-                Notifier notifier = [=]() {
-                    std::unique_lock<std::mutex> lock_worker(mutex_worker);
-                    worker_ready[workerID] = true;
-                    cv_worker.notify_one();
-                };
 
                 lock_jobs.lock();
 
+                bool pinned = workerID < workerQueue.size() && !workerQueue[workerID].empty();
+                LaneID lane = pinned ? no_lane : select_lane(workerID);
+
+                JobQueue *queue = pinned ? &workerQueue[workerID] : 
+                    lane == 0 ? &scheduler->select(workerID) : 
+                    lane != no_lane ? &lanes[lane].queue : nullptr;
+
                 // check if there are still jobs in the queue
-                if (jobQueue.empty())
+                if (!queue || queue->empty() || stop)
                 {
-                    notifier();
+                    release_worker(workerID);
                     continue;
                 }
 
-                JobFuture &job = jobQueue.front();
+                JobFuture batch;
+                bool batched = lane == 0 && batch_size > 1 && make_batch(*queue, batch);
+                std::size_t pick = lane == 0 && !batched ? scheduler->pick(*queue, workerID) : 0;
+
+                JobFuture &job = batched ? batch : (*queue)[pick];
                 MATLABPOOL_ASSERT(job.get_status() == JobFeval::Status::Wait);
 
-                job.set_workerID(workerID); // set also job status to "InProgress"
-                worker->eval_job(job, std::move(notifier));
-                JobID id_tmp = job.get_ID();
-                futureMap[id_tmp] = std::move(job);
-                jobQueue.pop_front();
+                start_job(job, workerID, worker, batched, lane);
+                if (!batched)
+                    queue->erase(queue->begin() + pick);
+                if (pinned)
+                    --pinned_pending;
+                else if (lane > 0)
+                    --lane_pending;
                 cv_future.notify_one();
             }
             });
+
+        scaler = std::thread([this]() { autoscale(); });
     }
     PoolImpl::~PoolImpl()
     {
+        // join autoscaler thread, it may wait for a resize
+        {
+            std::unique_lock<std::mutex> lock(mutex_jobs);
+            stop = true;
+            cv_scale.notify_one();
+        }
+        scaler.join();
+
         // join master thread
         {
             std::unique_lock<std::mutex> lock(mutex_jobs);
@@ -78,21 +154,65 @@ namespace MatlabPool
         {
             std::unique_lock<std::mutex> lock(mutex_jobs);
             futureMap.clear();
+            detached.clear();
         }
     }
 
     void PoolImpl::resize(unsigned int n_new, const std::vector<std::u16string> &options)
     {
-        std::size_t n_old = engine.size();
         if (n_new == 0)
             throw EmptyPool();
 
+        std::unique_lock<std::mutex> lock_resize(mutex_resize);
+        engineOptions = options;
+        resize_engines(n_new, options);
+    }
+
+    bool PoolImpl::resize_engines(unsigned int n_new, const std::vector<std::u16string> &options,
+        bool keep)
+    {
+        std::size_t n_old;
+        {
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            n_old = engine.size();
+        }
+
+        if (n_new < n_old && keep)
+        {
+            // the master may just have started a job on a worker, so
+            // the workers are checked after they are released
+            {
+                std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+                sleep = true;
+            }
+            {
+                std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                for (std::size_t i = n_new; i < engine.size(); i++)
+                    while (!worker_ready[i])
+                        cv_worker.wait(lock_worker);
+            }
+
+            std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+            bool removable = true;
+            for (std::size_t i = n_new; i < n_old; i++)
+                removable = removable && !holds_results(i) && !hosts_actors(i) &&
+                    (i >= workerQueue.size() || workerQueue[i].empty());
+            if (!removable)
+            {
+                sleep = false;
+                cv_queue.notify_one();
+                return false;
+            }
+        }
+
         if (n_new < n_old)
         {
-            // block the master thread to avoid new job assignments
+            // block the master thread to avoid new job assignments, the
+            // pinned jobs of the removed workers get an error
             {
                 std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
                 sleep = true;
+                remove_workers(n_new);
             }
 
             {
@@ -114,29 +234,172 @@ namespace MatlabPool
                 sleep = false;
                 cv_queue.notify_one();
             }
+
+            // e.g. larger sets for the remaining workers
+            update_layout(n_new);
         }
         else if (n_new > n_old)
         {
-            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            // the profile must not change until the new engines are added
+            std::unique_lock<std::mutex> lock_init(mutex_init);
+            {
+                std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+                workerQueue.resize(n_new);
+                scheduler->resize(n_new);
+                running.resize(n_new);
+                served.resize(n_new, 0);
+            }
+
+            // the new engines are started with the sets of the new layout
+            update_layout(n_new);
+
+            // the running workers continue with their jobs while the 
+            // new engines start
             for (std::size_t i = n_old; i < n_new; i++)
             {
-                engine.push_back(std::make_unique<EngineHack>(options));
+                // the engine is ready after the initialization
+                EnginePtr e;
+                try
+                {
+                    e = start_engine(options, i);
+                }
+                catch (...)
+                {
+                    // the workers without an engine are removed again, 
+                    // e.g. their broadcast jobs get an error
+                    {
+                        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+                        remove_workers(i);
+                    }
+                    update_layout(i);
+                    throw;
+                }
+
+                std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                engine.push_back(std::move(e));
                 worker_ready.push_back(true);
+                cv_worker.notify_all();
+            }
+        }
+        return true;
+    }
+
+    void PoolImpl::remove_workers(std::size_t n)
+    {
+        for (auto &e : actors)
+            if (e.second.workerID >= n)
+                move_actor(e.first, e.second, select_actor_worker(n));
+        for (std::size_t i = n; i < workerQueue.size(); i++)
+        {
+            for (auto &job : workerQueue[i])
+            {
+                if (job.is_detached())
+                {
+                    --pinned_pending;
+                    continue;
+                }
+                job.set_error(u"the worker was removed");
+                JobID id = job.get_ID();
+                futureMap[id] = std::move(job);
+                --pinned_pending;
             }
         }
+        // the records of the removed workers are closed here, 
+        // "finish_run" ignores them
+        for (std::size_t i = n; i < running.size(); i++)
+            if (running[i].lane < lanes.size())
+                --lanes[running[i].lane].running;
+        workerQueue.resize(n);
+        scheduler->resize(n);
+        running.resize(n);
+        served.resize(n, 0);
+        for (auto it = residents.begin(); it != residents.end();)
+            it = it->second >= n ? residents.erase(it) : std::next(it);
+        cv_future.notify_all();
     }
 
     std::size_t PoolImpl::size() const
     {
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
         return engine.size();
     }
 
     JobID PoolImpl::submit(JobFeval &&job)
+    {
+        JobFuture tmp(std::move(job));
+
+        bool coalesce_tmp;
+        {
+            std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+            coalesce_tmp = coalesce;
+        }
+
+        Digest key;
+        bool memo_tmp = memo.enabled();
+        if ((memo_tmp || coalesce_tmp) && ResultCache::get_key(tmp, key))
+        {
+            tmp.set_jobKey(key);
+
+            // serve the results from the result cache
+            std::vector<matlab::data::Array> result;
+            if (memo_tmp && memo.lookup(tmp.get_cmd(), key, result))
+            {
+                tmp.set_result(std::move(result));
+                return submit_done(std::move(tmp));
+            }
+        }
+
+        return submit_job(std::move(tmp));
+    }
+
+    JobID PoolImpl::submit_done(JobFuture &&job)
     {
         JobID job_id = job.get_ID();
         std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
-        jobQueue.push_back(JobFuture(std::move(job)));
+        futureMap[job_id] = std::move(job);
+        cv_future.notify_all();
+        return job_id;
+    }
+
+    JobID PoolImpl::submit_job(JobFuture &&job)
+    {
+        JobID job_id = job.get_ID();
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        if (job.get_lane() >= lanes.size())
+            throw LaneNotExists(job.get_lane());
+
+        // attach the job to an identical job in the queue or in progress
+        if (coalesce && job.has_jobKey())
+        {
+            auto it = inflight.find(job.get_jobKey());
+            JobFuture *leader = it != inflight.end() ? find_job(it->second) : nullptr;
+            if (leader)
+            {
+                leader->add_follower(job_id);
+                job.set_leader(leader->get_ID());
+                futureMap[job_id] = std::move(job);
+                return job_id;
+            }
+            inflight[job.get_jobKey()] = job_id;
+        }
+
+        // hash large arguments without blocking the pool
+        std::size_t threshold = cache_threshold;
+        if (threshold > 0)
+        {
+            lock_jobs.unlock();
+            job.hash_args(threshold);
+            lock_jobs.lock();
+        }
+
+        queue_job(std::move(job));
         cv_queue.notify_one();
+        if (pinned_pending > 0)
+        {
+            // the master may wait for a worker with pinned jobs
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            cv_worker.notify_all();
+        }
         return job_id;
     }
 
@@ -147,26 +410,59 @@ namespace MatlabPool
 
         std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
 
+        // followers wait until their leader is finished, with the
+        // speculation the job waits in the future map, so a finished
+        // copy can provide the results
         decltype(futureMap)::iterator it;
-        while ((it = futureMap.find(id)) == futureMap.end())
+        while ((it = futureMap.find(id)) == futureMap.end() || it->second.is_pending() ||
+            (speculation > 0 && it->second.get_status() == JobFeval::Status::InProgress))
         {
             cv_future.wait(lock_jobs);
         }
 
-        auto job = std::move(futureMap[id]);
+        auto job = std::move(it->second);
 
         futureMap.erase(it);
+        lock_jobs.unlock(); // do not block the pool during the wait
         job.wait();
 
+        if (job.has_jobKey())
+        {
+            lock_jobs.lock();
+            share_result(job);
+            lock_jobs.unlock();
+
+            if (job.get_status() == JobFeval::Status::Done)
+                memo.insert(job.get_cmd(), job.get_jobKey(), job.peek_result());
+        }
+
+        // the notifier can not find the job anymore
+        if (job.is_parent())
+        {
+            lock_jobs.lock();
+            release_dependents(job);
+            lock_jobs.unlock();
+        }
+
         return std::move(job);
     }
 
     void PoolImpl::eval(JobEval &job)
     {
-        std::size_t n = engine.size();
+        // the autoscaler must not remove engines
+        std::unique_lock<std::mutex> lock_resize(mutex_resize);
+        std::size_t n = size();
 
         std::vector<StreamBuf> outBuf_vec(n);
         std::vector<StreamBuf> errBuf_vec(n);
+        {
+            std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                outBuf_vec[i].set_limit(output_limit);
+                errBuf_vec[i].set_limit(output_limit);
+            }
+        }
 
         std::vector<matlab::engine::FutureResult<void>> future(n);
 
@@ -186,13 +482,25 @@ namespace MatlabPool
                 job.add_error(errBuf_vec[i], i);
             }
             job.add_output(outBuf_vec[i], i);
+
+            // the command may clear the state of the worker, e.g. 
+            // "clear functions"
+            engine[i]->reset_state();
         }
     }
 
     matlab::data::StructArray PoolImpl::get_job_status()
     {
         std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
-        std::size_t n = jobQueue.size() + futureMap.size();
+        std::size_t n = futureMap.size() + blocked.size();
+        for (const auto &queue : scheduler->get_queues())
+            for (const auto &j : queue)
+                if (!j.is_detached())
+                    ++n;
+        for (const auto &lane : lanes)
+            for (const auto &j : lane.queue)
+                if (!j.is_detached())
+                    ++n;
 
         using StatusType = std::underlying_type<JobFeval::Status>::type;
 
@@ -201,12 +509,29 @@ namespace MatlabPool
         auto worker = factory.createArray<int>({ n });
 
         std::size_t i = 0;
-        for (const auto &j : jobQueue)
+        for (const auto &queue : scheduler->get_queues())
         {
-            jobID[i] = j.get_ID();
-            status[i] = static_cast<StatusType>(j.get_status());
-            worker[i] = j.get_workerID();
-            ++i;
+            for (const auto &j : queue)
+            {
+                if (j.is_detached())
+                    continue;
+                jobID[i] = j.get_ID();
+                status[i] = static_cast<StatusType>(j.get_status());
+                worker[i] = j.get_workerID();
+                ++i;
+            }
+        }
+        for (const auto &lane : lanes)
+        {
+            for (const auto &j : lane.queue)
+            {
+                if (j.is_detached())
+                    continue;
+                jobID[i] = j.get_ID();
+                status[i] = static_cast<StatusType>(j.get_status());
+                worker[i] = j.get_workerID();
+                ++i;
+            }
         }
         for (const auto &j : futureMap)
         {
@@ -215,6 +540,13 @@ namespace MatlabPool
             worker[i] = j.second.get_workerID();
             ++i;
         }
+        for (const auto &j : blocked)
+        {
+            jobID[i] = j.second.get_ID();
+            status[i] = static_cast<StatusType>(j.second.get_status());
+            worker[i] = j.second.get_workerID();
+            ++i;
+        }
         lock_jobs.unlock();
 
         auto result = factory.createStructArray({ 1 },
@@ -232,13 +564,64 @@ namespace MatlabPool
         std::size_t n = engine.size();
 
         auto ready = factory.createArray<bool>({ n });
+        auto pid = factory.createArray<std::uint64_t>({ n });
+        auto memory = factory.createArray<std::uint64_t>({ n });
+        auto node = factory.createArray<std::int32_t>({ n });
+        auto cpus = factory.createCellArray({ n });
         for (std::size_t i = 0; i < n; i++)
+        {
             ready[i] = worker_ready[i];
+            pid[i] = engine[i]->get_pid();
+            memory[i] = engine[i]->get_memory();
+            const CpuSet &set = engine[i]->get_cpus();
+            node[i] = set.empty() ? -1 : layout.get_node(i);
+            cpus[i] = factory.createArray({ 1, set.size() }, set.begin(), set.end());
+        }
 
         lock_worker.unlock();
 
-        auto result = factory.createStructArray({ 1 }, { "Ready" });
+        auto result = factory.createStructArray({ 1 }, 
+            { "Ready", "Pid", "Cpus", "Node", "Memory" });
         result[0]["Ready"] = std::move(ready);
+        result[0]["Pid"] = std::move(pid);
+        result[0]["Cpus"] = std::move(cpus);
+        result[0]["Node"] = std::move(node);
+        result[0]["Memory"] = std::move(memory);
+        return result;
+    }
+
+    matlab::data::StructArray PoolImpl::get_pool_status()
+    {
+        ResultCache::Stats memoStats = memo.get_stats();
+
+        std::uint64_t copies, wins, ups, downs, recycles, passed;
+        {
+            std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+            copies = speculation_count;
+            wins = speculation_wins;
+            ups = scale_ups;
+            downs = scale_downs;
+            recycles = recycled;
+            passed = passed_results;
+        }
+
+        auto result = factory.createStructArray({ 1 },
+            { "MemoHits", "MemoMisses", "MemoEntries", "MemoBytes", "HeapAllocations",
+            "SpeculativeCopies", "SpeculativeWins", "ScaleUps", "ScaleDowns",
+            "RecycledEngines", "PassedResults" });
+        result[0]["MemoHits"] = factory.createScalar<std::uint64_t>(memoStats.hits);
+        result[0]["MemoMisses"] = factory.createScalar<std::uint64_t>(memoStats.misses);
+        result[0]["MemoEntries"] = factory.createScalar<std::uint64_t>(memoStats.entries);
+        result[0]["MemoBytes"] = factory.createScalar<std::uint64_t>(memoStats.bytes);
+        result[0]["HeapAllocations"] = factory.createScalar<std::uint64_t>(
+            SlabPool::get_heap_allocations());
+        result[0]["SpeculativeCopies"] = factory.createScalar<std::uint64_t>(copies);
+        result[0]["SpeculativeWins"] = factory.createScalar<std::uint64_t>(wins);
+        result[0]["ScaleUps"] = factory.createScalar<std::uint64_t>(ups);
+        result[0]["ScaleDowns"] = factory.createScalar<std::uint64_t>(downs);
+        result[0]["RecycledEngines"] = factory.createScalar<std::uint64_t>(recycles);
+        result[0]["PassedResults"] = factory.createScalar<std::uint64_t>(passed);
+
         return result;
     }
 
@@ -246,13 +629,47 @@ namespace MatlabPool
     {
         std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
 
-        // job queue
-        for (auto it_job = jobQueue.begin(); it_job != jobQueue.end(); ++it_job)
+        // job queues
+        for (auto &queue : scheduler->get_queues())
         {
-            if (it_job->get_ID() == jobID)
+            for (auto it_job = queue.begin(); it_job != queue.end(); ++it_job)
             {
-                jobQueue.erase(it_job);
-                return;
+                if (it_job->get_ID() == jobID && !it_job->is_detached())
+                {
+                    // the followers still need the results
+                    if (it_job->has_followers())
+                    {
+                        it_job->set_detached();
+                        return;
+                    }
+                    release_key(*it_job);
+                    unref_inputs(*it_job);
+                    queue.erase(it_job);
+                    fail_dependents(jobID);
+                    return;
+                }
+            }
+        }
+
+        // queues of the lanes
+        for (auto &lane : lanes)
+        {
+            for (auto it_job = lane.queue.begin(); it_job != lane.queue.end(); ++it_job)
+            {
+                if (it_job->get_ID() == jobID && !it_job->is_detached())
+                {
+                    if (it_job->has_followers())
+                    {
+                        it_job->set_detached();
+                        return;
+                    }
+                    release_key(*it_job);
+                    unref_inputs(*it_job);
+                    lane.queue.erase(it_job);
+                    --lane_pending;
+                    fail_dependents(jobID);
+                    return;
+                }
             }
         }
 
@@ -260,8 +677,57 @@ namespace MatlabPool
         auto it_future = futureMap.find(jobID);
         if (it_future != futureMap.end())
         {
+            if (it_future->second.has_followers())
+            {
+                it_future->second.set_detached();
+                detached[jobID] = std::move(it_future->second);
+                futureMap.erase(it_future);
+                return;
+            }
+            release_key(it_future->second);
+
+            // the worker has possibly not stored the arguments
+            if (it_future->second.get_status() == JobFeval::Status::InProgress &&
+                (!it_future->second.get_argDigests().empty() ||
+                    it_future->second.get_template()))
+            {
+                std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                std::size_t workerID = it_future->second.get_workerID();
+                if (workerID < engine.size())
+                    engine[workerID]->reset_state();
+            }
+            discard_runtime(it_future->second);
+            resolve_speculation(jobID);
             it_future->second.cancel();
             futureMap.erase(it_future);
+            fail_dependents(jobID);
+            return;
+        }
+
+        // pinned jobs, e.g. consumers of worker-resident results
+        for (auto &queue : workerQueue)
+        {
+            for (auto it_job = queue.begin(); it_job != queue.end(); ++it_job)
+            {
+                if (it_job->get_ID() == jobID)
+                {
+                    unref_inputs(*it_job);
+                    queue.erase(it_job);
+                    --pinned_pending;
+                    fail_dependents(jobID);
+                    return;
+                }
+            }
+        }
+
+        // jobs of a graph
+        auto it_blocked = blocked.find(jobID);
+        if (it_blocked != blocked.end())
+        {
+            unref_inputs(it_blocked->second);
+            blocked.erase(it_blocked);
+            drop_reduction(jobID);
+            fail_dependents(jobID);
             return;
         }
 
@@ -273,38 +739,2193 @@ namespace MatlabPool
         std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
 
         // job queue
-        while (!jobQueue.empty() && jobQueue.back().get_status() == JobFeval::Status::Wait)
-            jobQueue.pop_back();
-        MATLABPOOL_ASSERT(jobQueue.empty());
+        for (auto &queue : scheduler->get_queues())
+        {
+            while (!queue.empty() && queue.back().get_status() == JobFeval::Status::Wait)
+                queue.pop_back();
+            MATLABPOOL_ASSERT(queue.empty());
+        }
+
+        // queues of the lanes
+        for (auto &lane : lanes)
+            lane.queue.clear();
+        lane_pending = 0;
+
+        // pinned jobs
+        for (auto &e : workerQueue)
+            e.clear();
+        pinned_pending = 0;
+        broadcasts.clear();
+
+        // jobs of a graph, the workers remove the stored results
+        blocked.clear();
+        dependents.clear();
+        reductions.clear();
+        distributed.clear();
+        if (!stored.empty() || !residents.empty())
+        {
+            stored.clear();
+            residents.clear();
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            for (auto &e : engine)
+                e->reset_results();
+        }
+
+        // the canceled jobs may not have stored their arguments
+        {
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            for (auto &e : engine)
+                e->reset_state();
+        }
 
         // future jobs
+        for (auto &e : running)
+            e.discard = true;
+        speculative.clear();
         futureMap.clear();
+        detached.clear();
+        inflight.clear();
+        lock_jobs.unlock();
+
+        // the jobs of the sinks and gather targets are removed
+        std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+        sinks.clear();
+        gathers.clear();
     }
 
-    bool PoolImpl::exists(JobID id) noexcept
+    void PoolImpl::set_argument_cache(std::size_t threshold, std::size_t capacity)
     {
         std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        cache_threshold = capacity > 0 ? threshold : 0;
+        lock_jobs.unlock();
 
-        for (const auto &e : jobQueue)
-            if (e.get_ID() == id)
-                return true;
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        cache_capacity = capacity;
+        for (auto &e : engine)
+            e->get_argumentCache().set_capacity(capacity);
+    }
 
-        for (const auto &e : futureMap)
-            if (e.first == id)
-                return true;
+    void PoolImpl::set_memoization(std::size_t capacity, const std::u16string &directory)
+    {
+        memo.configure(capacity, convertUTF16StringToASCIIString(directory));
+    }
 
-        return false;
+    void PoolImpl::invalidate_memoization(const std::u16string &fun)
+    {
+        memo.invalidate(fun);
     }
 
-    std::size_t PoolImpl::get_free_worker(std::unique_lock<std::mutex> &lock) noexcept
+    void PoolImpl::set_coalescing(bool val)
     {
-        for (;;)
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        coalesce = val;
+    }
+
+    void PoolImpl::set_batching(std::size_t size, double window)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        batch_size = size;
+        batch_window = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(window));
+        cv_queue.notify_one();
+    }
+
+    void PoolImpl::set_scheduler(Scheduler type)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto tmp = JobScheduler::create(type, workerQueue.size(), costs);
+        for (auto &queue : scheduler->get_queues())
+            for (auto &job : queue)
+                tmp->push(std::move(job));
+        scheduler = std::move(tmp);
+        cv_queue.notify_one();
+    }
+
+    void PoolImpl::set_speculation(double factor)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        speculation = factor > 0 ? factor : 0.0;
+        cv_queue.notify_one();
+
+        // the clients, which wait for a speculative job, block on the
+        // future after the speculation is disabled
+        cv_future.notify_all();
+    }
+
+    void PoolImpl::set_autoscaling(const Autoscaling &val)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        autoscaling = val;
+        if (autoscaling.maxSize < autoscaling.minSize)
+            autoscaling.maxSize = autoscaling.minSize;
+        cv_scale.notify_one();
+    }
+
+    void PoolImpl::set_recycling(std::size_t maxJobs, std::size_t maxMemory)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        recycle_jobs = maxJobs;
+        recycle_memory = maxMemory;
+        cv_scale.notify_one();
+    }
+
+    void PoolImpl::set_cpu_pinning(bool enable, std::size_t cpusPerWorker, bool numaSpread)
+    {
+        // the layout is rebuilt when the pool is resized
+        std::unique_lock<std::mutex> lock_resize(mutex_resize);
         {
-            for (std::size_t i = 0; i < worker_ready.size(); i++)
-                if (worker_ready[i])
-                    return i;
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            pinning = enable;
+            pin_cpus = cpusPerWorker;
+            pin_numa = numaSpread;
+        }
+        if (enable)
+            update_layout(size());
+        else
+        {
+            std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+            {
+                std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                apply_layout(CpuLayout());
+            }
+            notify_pinned();
+        }
+    }
 
-            cv_worker.wait(lock);
+    void PoolImpl::update_layout(std::size_t n)
+    {
+        std::size_t cpusPerWorker;
+        bool numaSpread;
+        {
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            if (!pinning)
+                return;
+            cpusPerWorker = pin_cpus;
+            numaSpread = pin_numa;
+        }
+        CpuLayout tmp(n, cpusPerWorker, numaSpread);
+
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        {
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            apply_layout(std::move(tmp));
+        }
+        notify_pinned();
+    }
+
+    void PoolImpl::apply_layout(CpuLayout &&tmp)
+    {
+        layout = std::move(tmp);
+        for (std::size_t i = 0; i < engine.size() && i < workerQueue.size(); i++)
+        {
+            // e.g. the first workers keep their sets when a worker is added
+            const CpuSet &cpus = layout.get_cpus(i);
+            if (cpus == engine[i]->get_cpus() || !engine[i]->pin(cpus))
+                continue;
+
+            // nobody waits for the job, see "drop_job"
+            JobFuture job(JobFeval(u"maxNumCompThreads", 0, { cpus.empty() ?
+                matlab::data::Array(factory.createCharArray("automatic")) :
+                matlab::data::Array(factory.createScalar<double>(double(cpus.size()))) }));
+            job.set_detached();
+            workerQueue[i].push_back(std::move(job));
+            ++pinned_pending;
+        }
+    }
+
+    LaneID PoolImpl::add_lane(std::u16string name, std::size_t reserved, double maxShare)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        LaneID id = 0;
+        while (id < lanes.size() && lanes[id].name != name)
+            ++id;
+        if (id == lanes.size())
+        {
+            lanes.emplace_back();
+            lanes.back().name = std::move(name);
+        }
+        lanes[id].reserved = reserved;
+        lanes[id].maxShare = std::min(std::max(maxShare, 0.0), 1.0);
+        cv_queue.notify_one();
+        return id;
+    }
+
+    matlab::data::StructArray PoolImpl::get_lane_status()
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        std::size_t n = lanes.size();
+
+        auto name = factory.createCellArray({ n });
+        auto reserved = factory.createArray<std::uint64_t>({ n });
+        auto maxShare = factory.createArray<double>({ n });
+        auto queued = factory.createArray<std::uint64_t>({ n });
+        auto nof_running = factory.createArray<std::uint64_t>({ n });
+        auto started = factory.createArray<std::uint64_t>({ n });
+        auto meanWait = factory.createArray<double>({ n });
+        auto maxWait = factory.createArray<double>({ n });
+
+        for (std::size_t i = 0; i < n; i++)
+        {
+            const Lane &lane = lanes[i];
+            std::size_t depth = 0;
+            if (i == 0)
+            {
+                for (const auto &queue : scheduler->get_queues())
+                    for (const auto &j : queue)
+                        if (!j.is_detached())
+                            ++depth;
+            }
+            else
+            {
+                depth = lane.queue.size();
+            }
+
+            name[i] = factory.createCharArray(lane.name);
+            reserved[i] = lane.reserved;
+            maxShare[i] = lane.maxShare;
+            queued[i] = depth;
+            nof_running[i] = lane.running;
+            started[i] = lane.started;
+            meanWait[i] = lane.started > 0 ? lane.waitSum / double(lane.started) : 0.0;
+            maxWait[i] = lane.waitMax;
+        }
+        lock_jobs.unlock();
+
+        auto result = factory.createStructArray({ 1 }, { "Name", "Reserved", "MaxShare",
+            "Queued", "Running", "Started", "MeanWait", "MaxWait" });
+        result[0]["Name"] = std::move(name);
+        result[0]["Reserved"] = std::move(reserved);
+        result[0]["MaxShare"] = std::move(maxShare);
+        result[0]["Queued"] = std::move(queued);
+        result[0]["Running"] = std::move(nof_running);
+        result[0]["Started"] = std::move(started);
+        result[0]["MeanWait"] = std::move(meanWait);
+        result[0]["MaxWait"] = std::move(maxWait);
+        return result;
+    }
+
+    void PoolImpl::set_output_limit(std::size_t limit)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        output_limit = limit;
+    }
+
+    std::u16string PoolImpl::read_output(JobID id, bool error)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        JobFuture *job = find_job(id);
+        if (!job || job->is_detached())
+            throw JobNotExists(id);
+
+        StreamBuf &buf = error ? job->get_errBuf() : job->get_outBuf();
+        return buf.read_new();
+    }
+
+    TemplateID PoolImpl::register_template(std::u16string fun, std::size_t nlhs,
+        std::vector<matlab::data::Array> &&fixedArgs)
+    {
+        auto tmpl = std::make_shared<JobTemplate>();
+        tmpl->fun = std::move(fun);
+        tmpl->nlhs = nlhs;
+        tmpl->funAscii = convertUTF16StringToASCIIString(tmpl->fun);
+        tmpl->funArray = factory.createCharArray(tmpl->fun);
+        tmpl->fixedArgs = factory.createCellArray({ 1, fixedArgs.size() });
+        for (std::size_t i = 0; i < fixedArgs.size(); i++)
+            tmpl->fixedArgs[i] = std::move(fixedArgs[i]);
+
+        std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+        tmpl->id = template_count++;
+        templates[tmpl->id] = tmpl;
+        return tmpl->id;
+    }
+
+    JobID PoolImpl::submit(TemplateID id, std::vector<matlab::data::Array> &&args)
+    {
+        std::shared_ptr<const JobTemplate> tmpl;
+        {
+            std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+            auto it = templates.find(id);
+            if (it == templates.end())
+                throw TemplateNotExists(id);
+            tmpl = it->second;
+        }
+
+        // the name of the function is taken from the template (see
+        // "JobFuture::get_cmd")
+        JobFuture job(JobFeval(std::u16string(), tmpl->nlhs, std::move(args)));
+        job.set_template(std::move(tmpl));
+        return submit_job(std::move(job));
+    }
+
+    void PoolImpl::unregister_template(TemplateID id)
+    {
+        {
+            std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+            auto it = templates.find(id);
+            if (it == templates.end())
+                throw TemplateNotExists(id);
+            it->second->released = true;
+            templates.erase(it);
+        }
+
+        // queued jobs of the template are still valid, they send the
+        // fixed arguments with the job and do not pin them again
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        for (auto &e : engine)
+            e->unpin_template(id);
+    }
+
+    BroadcastID PoolImpl::broadcast(std::u16string fun, std::size_t nlhs,
+        std::vector<matlab::data::Array> &&args)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        BroadcastID id = queue_broadcast(fun, nlhs, args, workerQueue.size());
+        notify_pinned();
+        return id;
+    }
+
+    BroadcastID PoolImpl::queue_broadcast(const std::u16string &fun, std::size_t nlhs,
+        const std::vector<matlab::data::Array> &args, std::size_t n)
+    {
+        MATLABPOOL_ASSERT(n <= workerQueue.size());
+        BroadcastID id = broadcast_count++;
+        auto &ids = broadcasts[id];
+
+        // the arrays are shared by the copies of the arguments
+        for (std::size_t i = 0; i < n; i++)
+        {
+            JobFuture job(JobFeval(fun, nlhs, { args.begin(), args.end() }));
+            ids.push_back(job.get_ID());
+            workerQueue[i].push_back(std::move(job));
+            ++pinned_pending;
+        }
+        cv_queue.notify_one();
+        return id;
+    }
+
+    BroadcastID PoolImpl::add_init_eval(std::u16string cmd)
+    {
+        return add_init_step({ u"evalin", 0, 
+            { factory.createCharArray("base"), factory.createCharArray(cmd) } });
+    }
+
+    BroadcastID PoolImpl::add_init_feval(std::u16string fun, std::size_t nlhs,
+        std::vector<matlab::data::Array> &&args)
+    {
+        return add_init_step({ std::move(fun), nlhs, std::move(args) });
+    }
+
+    BroadcastID PoolImpl::add_init_step(InitStep &&step)
+    {
+        std::unique_lock<std::mutex> lock_init(mutex_init);
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        BroadcastID id;
+        {
+            // only the started engines, a new engine evaluates the 
+            // step with the profile
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            id = queue_broadcast(step.fun, step.nlhs, step.args,
+                std::min(engine.size(), workerQueue.size()));
+        }
+        notify_pinned();
+
+        // a failing step would fail every new engine, e.g. each grow 
+        // of the autoscaler
+        if (broadcast_succeeded(id, lock_jobs))
+            initProfile.push_back(std::move(step));
+        return id;
+    }
+
+    bool PoolImpl::broadcast_succeeded(BroadcastID id, std::unique_lock<std::mutex> &lock_jobs)
+    {
+        auto it_broadcast = broadcasts.find(id);
+        if (it_broadcast == broadcasts.end())
+            return false;
+        std::vector<JobID> ids = it_broadcast->second;
+
+        for (JobID job_id : ids)
+        {
+            for (;;)
+            {
+                if (stop)
+                    return false;
+
+                // the job stays in "futureMap" for "wait_broadcast"
+                auto it = futureMap.find(job_id);
+                if (it != futureMap.end())
+                {
+                    auto status = it->second.get_status();
+                    if (status != JobFeval::Status::Wait && status != JobFeval::Status::InProgress)
+                    {
+                        it->second.wait();
+                        if (it->second.get_status() != JobFeval::Status::Done)
+                            return false;
+                        break;
+                    }
+                }
+                else if (!find_job(job_id))
+                    return false; // e.g. removed by "clear"
+
+                // the notifiers do not signal every finished job
+                cv_future.wait_for(lock_jobs, std::chrono::milliseconds(10));
+            }
+        }
+        return true;
+    }
+
+    void PoolImpl::clear_init()
+    {
+        std::unique_lock<std::mutex> lock_init(mutex_init);
+        initProfile.clear();
+    }
+
+    PoolImpl::EnginePtr PoolImpl::start_engine(const std::vector<std::u16string> &options,
+        std::size_t workerID)
+    {
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        std::size_t capacity = cache_capacity;
+        CpuSet cpus = layout.get_cpus(workerID);
+        lock_worker.unlock();
+
+        auto e = std::make_unique<EngineHack>(options, cpus);
+        e->get_argumentCache().set_capacity(capacity);
+
+        for (const auto &step : initProfile)
+        {
+            try
+            {
+                e->feval(step.fun, int(step.nlhs), step.args);
+            }
+            catch (const matlab::engine::Exception &ex)
+            {
+                throw InitError(step.fun, ex.what());
+            }
+        }
+        return e;
+    }
+
+    std::vector<JobFeval> PoolImpl::wait_broadcast(BroadcastID id)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it_broadcast = broadcasts.find(id);
+        if (it_broadcast == broadcasts.end())
+            throw BroadcastNotExists(id);
+        std::vector<JobID> ids = std::move(it_broadcast->second);
+        broadcasts.erase(it_broadcast);
+
+        std::vector<JobFeval> result;
+        result.reserve(ids.size());
+        for (JobID job_id : ids)
+            result.push_back(take_job(job_id, lock_jobs));
+        return result;
+    }
+
+    JobFeval PoolImpl::take_job(JobID id, std::unique_lock<std::mutex> &lock_jobs)
+    {
+        decltype(futureMap)::iterator it;
+        while ((it = futureMap.find(id)) == futureMap.end())
+        {
+            // the job was removed, e.g. by "clear"
+            if (!find_job(id))
+                throw JobNotExists(id);
+            cv_future.wait(lock_jobs);
+        }
+
+        JobFuture job = std::move(it->second);
+        futureMap.erase(it);
+        lock_jobs.unlock(); // do not block the pool during the wait
+        job.wait();
+        lock_jobs.lock();
+        return std::move(job);
+    }
+
+    void PoolImpl::notify_pinned()
+    {
+        cv_queue.notify_one();
+
+        // the master may wait for another worker
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        cv_worker.notify_all();
+    }
+
+    JobID PoolImpl::submit(JobFeval &&job, std::vector<JobDependency> &&deps)
+    {
+        JobFuture tmp(std::move(job));
+        for (const auto &d : deps)
+            if (d.arg != JobDependency::none && d.arg >= tmp.get_args().size())
+                throw InvalidDependency();
+
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        for (const auto &d : deps)
+        {
+            JobFuture *parent = find_job(d.job);
+            if ((!parent && residents.count(d.job) == 0) || (parent && parent->is_detached()))
+                throw JobNotExists(d.job);
+        }
+        return add_job(std::move(tmp), std::move(deps));
+    }
+
+    JobID PoolImpl::add_job(JobFuture &&tmp, std::vector<JobDependency> &&deps)
+    {
+        JobID job_id = tmp.get_ID();
+        std::size_t blocking = 0;
+        bool failed = false;
+        for (const auto &d : deps)
+        {
+            // a worker-resident result, which is already waited for
+            if (!find_job(d.job))
+            {
+                if (d.arg != JobDependency::none)
+                    tmp.add_storedInput({ d.arg, d.job, d.output });
+                continue;
+            }
+
+            JobFuture &parent = *find_job(d.job);
+            auto status = parent.get_status();
+            bool finished = !parent.is_pending() && (status == JobFeval::Status::Done ||
+                status == JobFeval::Status::Error || status == JobFeval::Status::Canceled);
+
+            // a stored result waits for this job as well
+            auto it = stored.find(d.job);
+            if (d.arg != JobDependency::none && it != stored.end())
+                ++it->second.refs;
+
+            if (finished)
+            {
+                parent.wait();
+                failed = !pass_result(tmp, d, parent) || failed;
+            }
+            else if (dependents.find(d.job) == dependents.end() || 
+                std::prev(dependents.upper_bound(d.job))->second != job_id)
+            {
+                parent.set_parent();
+                dependents.emplace(d.job, job_id);
+                ++blocking;
+            }
+        }
+        tmp.set_dependencies(std::move(deps));
+
+        if (failed)
+        {
+            unref_inputs(tmp);
+            tmp.set_error(u"a dependency of the job failed");
+            JobFuture &failedJob = futureMap[job_id] = std::move(tmp);
+            release_dependents(failedJob);
+        }
+        else if (blocking == 0)
+        {
+            release_job(std::move(tmp));
+        }
+        else
+        {
+            tmp.set_blocking(blocking);
+            blocked[job_id] = std::move(tmp);
+        }
+        return job_id;
+    }
+
+    void PoolImpl::release_job(JobFuture &&job)
+    {
+        // the map jobs of a reduction are finished
+        auto it_reduction = reductions.find(job.get_ID());
+        if (it_reduction != reductions.end())
+        {
+            std::vector<JobID> parts = std::move(it_reduction->second);
+            reductions.erase(it_reduction);
+            expand_reduction(std::move(job), parts);
+            return;
+        }
+
+        // the consumers of worker-resident results are evaluated by 
+        // the worker which holds the results
+        std::size_t owner = no_worker;
+        for (const auto &input : job.get_storedInputs())
+        {
+            auto it = residents.find(input.job);
+            std::size_t workerID = it != residents.end() ? it->second : no_worker;
+            if (workerID == no_worker || (owner != no_worker && owner != workerID))
+            {
+                JobID id = job.get_ID();
+                unref_inputs(job);
+                job.set_error(workerID == no_worker
+                    ? u"the worker-resident result " + convertASCIIStringToUTF16String(
+                        std::to_string(input.job)) + u" does not exist"
+                    : u"the worker-resident results are stored by different workers");
+                JobFuture &failed = futureMap[id] = std::move(job);
+                release_dependents(failed);
+                return;
+            }
+            owner = workerID;
+        }
+        if (owner != no_worker)
+        {
+            workerQueue[owner].push_back(std::move(job));
+            ++pinned_pending;
+            notify_pinned();
+            return;
+        }
+
+        // prefer the worker of the first stored input
+        for (const auto &d : job.get_dependencies())
+        {
+            auto it = stored.find(d.job);
+            if (d.arg != JobDependency::none && it != stored.end())
+            {
+                job.set_affinity(int(it->second.workerID));
+                break;
+            }
+        }
+
+        queue_job(std::move(job));
+        if (pinned_pending > 0)
+            notify_pinned(); // the master may wait for a worker with pinned jobs
+        else
+            cv_queue.notify_one();
+    }
+
+    void PoolImpl::release_dependents(JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        if (dependents.find(id) == dependents.end())
+            return;
+
+        // the job is waited for by the client, "wait" releases the 
+        // dependents
+        JobFuture *job = find_job(id);
+        if (!job || job->is_pending())
+            return;
+        job->wait();
+        release_dependents(*job);
+    }
+
+    void PoolImpl::release_dependents(JobFuture &parent) noexcept
+    {
+        JobID id = parent.get_ID();
+        auto range = dependents.equal_range(id);
+        std::vector<JobID> children;
+        for (auto it = range.first; it != range.second; ++it)
+            children.push_back(it->second);
+        dependents.erase(range.first, range.second);
+
+        for (JobID child_id : children)
+        {
+            // the job is already failed or canceled
+            auto it = blocked.find(child_id);
+            if (it == blocked.end())
+                continue;
+            JobFuture &child = it->second;
+
+            bool ok = true;
+            for (const auto &d : child.get_dependencies())
+                if (d.job == id)
+                    ok = pass_result(child, d, parent) && ok;
+
+            if (!ok)
+            {
+                fail_job(child_id, u"the dependency " + 
+                    convertASCIIStringToUTF16String(std::to_string(id)) + u" failed");
+            }
+            else if (child.unblock())
+            {
+                JobFuture job = std::move(child);
+                blocked.erase(it);
+                release_job(std::move(job));
+            }
+        }
+        cv_future.notify_all();
+    }
+
+    void PoolImpl::fail_job(JobID id, const std::u16string &msg) noexcept
+    {
+        auto it = blocked.find(id);
+        if (it == blocked.end())
+            return;
+
+        JobFuture job = std::move(it->second);
+        blocked.erase(it);
+        unref_inputs(job);
+        drop_reduction(id);
+        job.set_error(msg);
+
+        JobFuture &failed = futureMap[id] = std::move(job);
+        release_dependents(failed);
+    }
+
+    void PoolImpl::fail_dependents(JobID id) noexcept
+    {
+        auto range = dependents.equal_range(id);
+        std::vector<JobID> children;
+        for (auto it = range.first; it != range.second; ++it)
+            children.push_back(it->second);
+        dependents.erase(range.first, range.second);
+
+        for (JobID child_id : children)
+            fail_job(child_id, u"the dependency " +
+                convertASCIIStringToUTF16String(std::to_string(id)) + u" is canceled");
+        cv_future.notify_all();
+    }
+
+    bool PoolImpl::pass_result(JobFuture &job, const JobDependency &dep,
+        const JobFuture &parent)
+    {
+        if (parent.get_status() != JobFeval::Status::Done)
+            return false;
+        if (dep.arg == JobDependency::none)
+            return true;
+        if (parent.is_resident())
+        {
+            // the values stay on the worker, the result holds only 
+            // their metadata
+            if (dep.output >= parent.peek_result()[0].getNumberOfElements())
+                return false;
+            job.add_storedInput({ dep.arg, dep.job, dep.output });
+            return true;
+        }
+        if (dep.output >= parent.peek_result().size())
+            return false;
+        job.get_args()[dep.arg] = parent.peek_result()[dep.output];
+        ++passed_results;
+        return true;
+    }
+
+    std::size_t PoolImpl::count_refs(JobID id) const noexcept
+    {
+        std::size_t refs = 0;
+        auto range = dependents.equal_range(id);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            auto it_child = blocked.find(it->second);
+            if (it_child == blocked.end())
+                continue;
+            for (const auto &d : it_child->second.get_dependencies())
+                if (d.job == id && d.arg != JobDependency::none)
+                    ++refs;
+        }
+        return refs;
+    }
+
+    void PoolImpl::unref_inputs(const JobFuture &job) noexcept
+    {
+        for (const auto &d : job.get_dependencies())
+        {
+            auto it = stored.find(d.job);
+            if (d.arg == JobDependency::none || it == stored.end())
+                continue;
+
+            MATLABPOOL_ASSERT(it->second.refs > 0);
+            if (--it->second.refs == 0)
+            {
+                std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                if (it->second.workerID < engine.size())
+                    engine[it->second.workerID]->release_result(d.job);
+                stored.erase(it);
+            }
+        }
+    }
+
+    JobID PoolImpl::submit_resident(JobFeval &&job)
+    {
+        JobFuture tmp(std::move(job));
+        tmp.set_resident();
+        JobID job_id = tmp.get_ID();
+
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        release_job(std::move(tmp));
+        return job_id;
+    }
+
+    std::vector<matlab::data::Array> PoolImpl::fetch_result(JobID ref)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = residents.find(ref);
+        if (it == residents.end())
+            throw ResultNotExists(ref);
+
+        // the worker evaluates the job after the job of the result
+        JobFuture tmp(JobFeval(u"MatlabPoolWorker.fetch_result", 1,
+            { factory.createScalar<JobID>(ref) }));
+        JobID job_id = tmp.get_ID();
+        workerQueue[it->second].push_back(std::move(tmp));
+        ++pinned_pending;
+        notify_pinned();
+
+        JobFeval job = take_job(job_id, lock_jobs);
+        if (job.get_status() != JobFeval::Status::Done)
+            throw JobBase::ExecutionError(job_id, job.get_errBuf());
+
+        matlab::data::CellArray cell = job.peek_result()[0];
+        return { cell.begin(), cell.end() };
+    }
+
+    void PoolImpl::free_result(JobID ref)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        if (!release_resident(ref))
+            throw ResultNotExists(ref);
+    }
+
+    bool PoolImpl::release_resident(JobID ref) noexcept
+    {
+        auto it = residents.find(ref);
+        if (it == residents.end())
+            return false;
+        std::size_t workerID = it->second;
+        residents.erase(it);
+
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        if (workerID < engine.size())
+            engine[workerID]->release_result(ref);
+        return true;
+    }
+
+    JobID PoolImpl::map_reduce(std::u16string fun, std::u16string reduceFun,
+        std::vector<std::vector<matlab::data::Array>> &&inputs)
+    {
+        if (inputs.empty())
+            throw EmptyReduction();
+
+        std::vector<MapJob> parts;
+        parts.reserve(inputs.size());
+        for (auto &args : inputs)
+            parts.push_back({ JobFuture(JobFeval(fun, 1, std::move(args))), {} });
+
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        return add_reduction(reduceFun, std::move(parts));
+    }
+
+    JobID PoolImpl::add_reduction(const std::u16string &reduceFun, 
+        std::vector<MapJob> &&parts)
+    {
+        // the final job waits for the map jobs, see "expand_reduction"
+        JobFuture job(JobFeval(reduce_dispatcher, 1, 
+            { factory.createCharArray(reduceFun), factory.createArray<JobID>({ 0, 0 }) }));
+        JobID job_id = job.get_ID();
+        std::vector<JobDependency> deps;
+        std::vector<JobID> ids;
+
+        for (auto &part : parts)
+        {
+            // the map jobs are removed after their evaluation
+            part.job.set_resident();
+            part.job.set_detached();
+            ids.push_back(part.job.get_ID());
+            deps.push_back({ part.job.get_ID(), JobDependency::none, JobDependency::none });
+            add_job(std::move(part.job), std::move(part.deps));
+        }
+        reductions[job_id] = std::move(ids);
+        add_job(std::move(job), std::move(deps));
+        return job_id;
+    }
+
+    DistributedID PoolImpl::distribute(matlab::data::Array data, std::size_t dim)
+    {
+        std::vector<std::size_t> dims = data.getDimensions();
+        if (dim >= dims.size())
+            throw InvalidSlice();
+
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        std::size_t n = std::max<std::size_t>(1, std::min(workerQueue.size(), dims[dim]));
+        lock_jobs.unlock(); // do not block the pool during the copies
+
+        // contiguous blocks, the first blocks are one element larger
+        std::vector<JobFuture> parts;
+        parts.reserve(n);
+        Utilities::Slice slice{ std::vector<std::size_t>(dims.size(), 0), dims };
+        for (std::size_t i = 0; i < n; i++)
+        {
+            slice.dims[dim] = dims[dim] / n + (i < dims[dim] % n ? 1 : 0);
+            parts.emplace_back(JobFeval(u"deal", 1, { Utilities::copyFromSlice(data, slice) }));
+            slice.offset[dim] += slice.dims[dim];
+        }
+
+        lock_jobs.lock();
+        DistributedID id = distributed_count++;
+        auto &ids = distributed[id];
+        for (std::size_t i = 0; i < parts.size(); i++)
+        {
+            // the worker keeps the block, see "submit_resident"
+            parts[i].set_resident();
+            parts[i].set_detached();
+            ids.push_back(parts[i].get_ID());
+            workerQueue[i % workerQueue.size()].push_back(std::move(parts[i]));
+            ++pinned_pending;
+        }
+        notify_pinned();
+        return id;
+    }
+
+    BroadcastID PoolImpl::spmd(DistributedID id, std::u16string fun,
+        std::size_t nlhs, std::vector<matlab::data::Array> &&args)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = distributed.find(id);
+        if (it == distributed.end())
+            throw DistributedNotExists(id);
+
+        BroadcastID broadcast_id = broadcast_count++;
+        auto &ids = broadcasts[broadcast_id];
+        for (auto &job : make_block_jobs(it->second, fun, nlhs, args))
+        {
+            ids.push_back(job.job.get_ID());
+            add_job(std::move(job.job), std::move(job.deps));
+        }
+        return broadcast_id;
+    }
+
+    JobID PoolImpl::spmd_reduce(DistributedID id, std::u16string fun,
+        std::u16string reduceFun, std::vector<matlab::data::Array> &&args)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = distributed.find(id);
+        if (it == distributed.end())
+            throw DistributedNotExists(id);
+
+        return add_reduction(reduceFun, make_block_jobs(it->second, fun, 1, args));
+    }
+
+    void PoolImpl::free_distributed(DistributedID id)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = distributed.find(id);
+        if (it == distributed.end())
+            throw DistributedNotExists(id);
+
+        // the blocks in progress are removed by "clear"
+        for (JobID block : it->second)
+        {
+            if (release_resident(block))
+                continue;
+            for (auto &queue : workerQueue)
+            {
+                for (auto it_job = queue.begin(); it_job != queue.end(); ++it_job)
+                {
+                    if (it_job->get_ID() == block)
+                    {
+                        queue.erase(it_job);
+                        --pinned_pending;
+                        break;
+                    }
+                }
+            }
+        }
+        distributed.erase(it);
+    }
+
+    std::vector<PoolImpl::MapJob> PoolImpl::make_block_jobs(const std::vector<JobID> &blocks,
+        const std::u16string &fun, std::size_t nlhs,
+        const std::vector<matlab::data::Array> &args)
+    {
+        // the first argument is replaced by the block
+        std::vector<MapJob> jobs;
+        jobs.reserve(blocks.size());
+        for (JobID block : blocks)
+        {
+            std::vector<matlab::data::Array> tmp;
+            tmp.reserve(args.size() + 1);
+            tmp.push_back(factory.createArray<double>({ 0, 0 }));
+            tmp.insert(tmp.end(), args.begin(), args.end());
+            jobs.push_back({ JobFuture(JobFeval(fun, nlhs, std::move(tmp))), 
+                { { block, 0, 0 } } });
+        }
+        return jobs;
+    }
+
+    void PoolImpl::expand_reduction(JobFuture &&job, const std::vector<JobID> &parts)
+    {
+        std::map<std::size_t, std::vector<JobID>> local;
+        for (JobID id : parts)
+        {
+            auto it = residents.find(id);
+            if (it == residents.end())
+            {
+                // e.g. the worker was removed
+                JobID job_id = job.get_ID();
+                job.set_error(u"a partial result of the reduction does not exist");
+                JobFuture &failed = futureMap[job_id] = std::move(job);
+                release_dependents(failed);
+                for (JobID part : parts)
+                    residents.erase(part);
+                return;
+            }
+            local[it->second].push_back(id);
+        }
+
+        // the final job runs on the worker with the most partial 
+        // results, the other workers reduce their partial results
+        // first and return them
+        auto main = std::max_element(local.begin(), local.end(),
+            [](const auto &a, const auto &b) { return a.second.size() < b.second.size(); });
+
+        auto add_inputs = [&](JobFuture &target, const std::vector<JobID> &ids,
+            std::vector<JobDependency> &deps) {
+            auto &args = target.get_args();
+            args[1] = factory.createArray({ 1, ids.size() }, ids.cbegin(), ids.cend());
+            for (JobID id : ids)
+            {
+                deps.push_back({ id, 0, args.size() });
+                args.push_back(factory.createArray<double>({ 0, 0 }));
+            }
+        };
+
+        std::vector<JobDependency> deps;
+        add_inputs(job, main->second, deps);
+        for (const auto &e : local)
+        {
+            if (e.first == main->first)
+                continue;
+
+            JobFuture partial(JobFeval(reduce_dispatcher, 1,
+                { job.get_args()[0], factory.createArray<JobID>({ 0, 0 }) }));
+            partial.set_detached();
+            std::vector<JobDependency> partial_deps;
+            add_inputs(partial, e.second, partial_deps);
+
+            auto &args = job.get_args();
+            deps.push_back({ partial.get_ID(), 0, args.size() });
+            args.push_back(factory.createArray<double>({ 0, 0 }));
+            add_job(std::move(partial), std::move(partial_deps));
+        }
+        add_job(std::move(job), std::move(deps));
+
+        // the workers remove the partial results after the reduction
+        for (JobID id : parts)
+            residents.erase(id);
+    }
+
+    void PoolImpl::drop_reduction(JobID id) noexcept
+    {
+        auto it = reductions.find(id);
+        if (it == reductions.end())
+            return;
+
+        // the map jobs in progress keep their results until "clear"
+        for (JobID part : it->second)
+        {
+            release_resident(part);
+            for (auto &queue : scheduler->get_queues())
+            {
+                for (auto it_job = queue.begin(); it_job != queue.end(); ++it_job)
+                {
+                    if (it_job->get_ID() == part)
+                    {
+                        queue.erase(it_job);
+                        break;
+                    }
+                }
+            }
+        }
+        reductions.erase(it);
+    }
+
+    ActorID PoolImpl::create_actor(std::u16string fun,
+        std::vector<matlab::data::Array> &&args)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        ActorID id = actor_count++;
+        Actor &actor = actors[id] = { select_actor_worker(workerQueue.size()),
+            std::move(fun), std::move(args) };
+
+        JobFuture job = make_actor_job("create", id, actor.fun, 0, 
+            { actor.args.begin(), actor.args.end() });
+        JobID job_id = job.get_ID();
+        workerQueue[actor.workerID].push_back(std::move(job));
+        ++pinned_pending;
+        notify_pinned();
+
+        JobFeval result = take_job(job_id, lock_jobs);
+        if (result.get_status() != JobFeval::Status::Done)
+        {
+            actors.erase(id);
+            throw JobBase::ExecutionError(job_id, result.get_errBuf());
+        }
+        return id;
+    }
+
+    JobID PoolImpl::call_actor(ActorID id, std::u16string method,
+        std::size_t nlhs, std::vector<matlab::data::Array> &&args)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = actors.find(id);
+        if (it == actors.end())
+            throw ActorNotExists(id);
+
+        JobFuture job = make_actor_job("call", id, method, nlhs, std::move(args));
+        JobID job_id = job.get_ID();
+        workerQueue[it->second.workerID].push_back(std::move(job));
+        ++pinned_pending;
+        notify_pinned();
+        return job_id;
+    }
+
+    matlab::data::Array PoolImpl::fetch_actor(ActorID id)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = actors.find(id);
+        if (it == actors.end())
+            throw ActorNotExists(id);
+
+        JobFuture job = make_actor_job("fetch", id, u"", 1, {});
+        JobID job_id = job.get_ID();
+        workerQueue[it->second.workerID].push_back(std::move(job));
+        ++pinned_pending;
+        notify_pinned();
+
+        return take_job(job_id, lock_jobs).pop_result()[0];
+    }
+
+    void PoolImpl::destroy_actor(ActorID id)
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = actors.find(id);
+        if (it == actors.end())
+            throw ActorNotExists(id);
+
+        // nobody waits for the job, see "drop_job"
+        JobFuture job = make_actor_job("destroy", id, u"", 0, {});
+        job.set_detached();
+        workerQueue[it->second.workerID].push_back(std::move(job));
+        ++pinned_pending;
+        actors.erase(it);
+        notify_pinned();
+    }
+
+    JobFuture PoolImpl::make_actor_job(const char *op, ActorID id,
+        const std::u16string &fun, std::size_t nlhs,
+        std::vector<matlab::data::Array> &&args)
+    {
+        std::vector<matlab::data::Array> tmp;
+        tmp.reserve(args.size() + 3);
+        tmp.push_back(factory.createCharArray(op));
+        tmp.push_back(factory.createScalar<ActorID>(id));
+        tmp.push_back(factory.createCharArray(fun));
+        std::move(args.begin(), args.end(), std::back_inserter(tmp));
+
+        JobFuture job(JobFeval(actor_dispatcher, nlhs, std::move(tmp)));
+        job.set_actor(id);
+        return job;
+    }
+
+    std::size_t PoolImpl::select_actor_worker(std::size_t n) const noexcept
+    {
+        std::vector<std::size_t> count(n, 0);
+        for (const auto &e : actors)
+            if (e.second.workerID < n)
+                ++count[e.second.workerID];
+        return std::size_t(std::min_element(count.begin(), count.end()) - count.begin());
+    }
+
+    void PoolImpl::move_actor(ActorID id, Actor &actor, std::size_t workerID)
+    {
+        // the constructor is evaluated again, the state is lost
+        JobFuture job = make_actor_job("create", id, actor.fun, 0,
+            { actor.args.begin(), actor.args.end() });
+        job.set_detached();
+        workerQueue[workerID].push_back(std::move(job));
+        ++pinned_pending;
+
+        // the queued methods follow the object
+        if (actor.workerID < workerQueue.size())
+        {
+            auto &queue = workerQueue[actor.workerID];
+            for (auto it = queue.begin(); it != queue.end();)
+            {
+                if (it->has_actor() && it->get_actor() == id)
+                {
+                    workerQueue[workerID].push_back(std::move(*it));
+                    it = queue.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+        actor.workerID = workerID;
+    }
+
+    void PoolImpl::drop_job(JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        auto it = detached.find(id);
+        if (it != detached.end())
+        {
+            it->second.wait();
+            detached.erase(it);
+        }
+    }
+
+    SinkID PoolImpl::create_sink(matlab::data::ArrayType type,
+        const std::vector<std::size_t> &dims)
+    {
+        auto sink = std::make_unique<OutputSink>(type, dims);
+
+        std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+        SinkID id = sink_count++;
+        sinks[id] = std::move(sink);
+        return id;
+    }
+
+    JobID PoolImpl::submit(JobFeval &&job, SinkID sink,
+        const Utilities::Slice &slice)
+    {
+        JobFuture tmp(std::move(job));
+        {
+            std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+            auto it = sinks.find(sink);
+            if (it == sinks.end())
+                throw SinkNotExists(sink);
+            tmp.add_spec("sink", it->second->add_slice(tmp.get_ID(), slice));
+        }
+        return submit_job(std::move(tmp));
+    }
+
+    matlab::data::Array PoolImpl::wait_sink(SinkID sink)
+    {
+        SinkPtr tmp;
+        {
+            std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+            auto it = sinks.find(sink);
+            if (it == sinks.end())
+                throw SinkNotExists(sink);
+            tmp = std::move(it->second);
+            sinks.erase(it);
+        }
+
+        // wait for all slices, the first error is thrown after
+        // all jobs are removed from the pool
+        std::exception_ptr error;
+        for (JobID id : tmp->get_jobs())
+        {
+            try
+            {
+                JobFeval job = wait(id);
+                if (job.get_status() == JobFeval::Status::Error)
+                    throw JobBase::ExecutionError(id, job.get_errBuf());
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+        if (error)
+            std::rethrow_exception(error);
+
+        return tmp->to_array();
+    }
+
+    GatherID PoolImpl::create_gather(matlab::data::Array output,
+        std::vector<Utilities::Slice> slices)
+    {
+        auto target = std::make_shared<GatherTarget>(std::move(output),
+            std::move(slices));
+
+        std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+        GatherID id = gather_count++;
+        gathers[id] = std::move(target);
+        return id;
+    }
+
+    JobID PoolImpl::submit(JobFeval &&job, GatherID gather, std::size_t slot)
+    {
+        JobFuture tmp(std::move(job));
+        {
+            std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+            auto it = gathers.find(gather);
+            if (it == gathers.end())
+                throw GatherNotExists(gather);
+            it->second->add_job(slot);
+            tmp.set_gather(it->second, slot);
+        }
+        return submit_job(std::move(tmp));
+    }
+
+    matlab::data::Array PoolImpl::wait_gather(GatherID gather)
+    {
+        std::shared_ptr<GatherTarget> target;
+        {
+            std::unique_lock<std::mutex> lock_sinks(mutex_sinks);
+            auto it = gathers.find(gather);
+            if (it == gathers.end())
+                throw GatherNotExists(gather);
+            target = std::move(it->second);
+            gathers.erase(it);
+        }
+        return target->wait();
+    }
+
+    void PoolImpl::gather_result(JobID id) noexcept
+    {
+        JobFuture job;
+        {
+            std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+            auto it = futureMap.find(id);
+            if (it == futureMap.end())
+                return; // the job is already canceled
+            job = std::move(it->second);
+            futureMap.erase(it);
+        }
+        job.gather();
+    }
+
+    void PoolImpl::queue_job(JobFuture &&job)
+    {
+        LaneID lane = job.get_lane();
+        if (lane > 0 && lane < lanes.size())
+        {
+            lanes[lane].queue.push_back(std::move(job));
+            ++lane_pending;
+        }
+        else
+        {
+            scheduler->push(std::move(job));
+        }
+    }
+
+    std::size_t PoolImpl::lane_limit(const Lane &lane) const noexcept
+    {
+        auto share = std::size_t(lane.maxShare * double(running.size()));
+        return std::max({ std::size_t(1), lane.reserved, share });
+    }
+
+    LaneID PoolImpl::select_lane(std::size_t workerID)
+    {
+        // lanes below their reservation first, then the oldest job
+        LaneID best = no_lane;
+        bool best_reserved = false;
+        std::chrono::steady_clock::time_point best_time;
+        for (LaneID i = 0; i < lanes.size(); i++)
+        {
+            const Lane &lane = lanes[i];
+            const JobQueue &queue = i == 0 ? scheduler->select(workerID) : lane.queue;
+            if (queue.empty() || lane.running >= lane_limit(lane))
+                continue;
+
+            bool reserved = lane.running < lane.reserved;
+            auto time = queue.front().get_submitTime();
+            if (best == no_lane || (reserved && !best_reserved) ||
+                (reserved == best_reserved && time < best_time))
+            {
+                best = i;
+                best_reserved = reserved;
+                best_time = time;
+            }
+        }
+        return best;
+    }
+
+    bool PoolImpl::has_lane_jobs()
+    {
+        if (!scheduler->empty() && lanes[0].running < lane_limit(lanes[0]))
+            return true;
+        if (lane_pending == 0)
+            return false;
+        for (LaneID i = 1; i < lanes.size(); i++)
+            if (!lanes[i].queue.empty() && lanes[i].running < lane_limit(lanes[i]))
+                return true;
+        return false;
+    }
+
+    void PoolImpl::start_job(JobFuture &job, std::size_t workerID,
+        EngineHack *worker, bool batched, LaneID lane)
+    {
+        JobID id_tmp = job.get_ID();
+        bool gather = job.has_gather();
+        bool share = job.has_jobKey();
+        bool drop = job.is_detached() && !share; // e.g. actor replays
+
+        // job graph: the worker keeps the results for the
+        // waiting jobs and provides its stored results
+        std::size_t refs = job.is_parent() && !job.is_resident() 
+            ? count_refs(id_tmp) : 0;
+        if (refs > 0)
+        {
+            job.set_keep(true);
+            stored[id_tmp] = { workerID, refs };
+        }
+        for (const auto &d : job.get_dependencies())
+        {
+            auto it = stored.find(d.job);
+            if (d.arg != JobDependency::none && it != stored.end() &&
+                it->second.workerID == workerID)
+                job.add_storedInput({ d.arg, d.job, d.output });
+        }
+        unref_inputs(job);
+        if (job.is_resident())
+            residents[id_tmp] = workerID;
+
+        // the arguments are kept before the worker replaces cached 
+        // arguments
+        ++served[workerID];
+        RunningJob &run = running[workerID];
+        run.reset();
+        run.id = id_tmp;
+        run.start = std::chrono::steady_clock::now();
+        if (!batched)
+        {
+            run.fun = job.get_cmd();
+            run.bytes = CostModel::get_bytes(job);
+        }
+        run.speculative = speculation > 0 && !batched && lane != no_lane && is_speculative(job);
+        if (run.speculative)
+        {
+            run.nlhs = job.get_nlhs();
+            run.args = job.get_args();
+        }
+
+        // statistics of the lane
+        run.lane = lane;
+        if (lane != no_lane)
+        {
+            std::chrono::duration<double> time = run.start - job.get_submitTime();
+            Lane &l = lanes[lane];
+            ++l.running;
+            ++l.started;
+            l.waitSum += time.count();
+            l.waitMax = std::max(l.waitMax, time.count());
+        }
+
+        job.get_outBuf().set_limit(output_limit);
+        job.get_errBuf().set_limit(output_limit);
+        job.set_workerID(workerID); // set also job status to "InProgress"
+        worker->eval_job(job, [=]() {
+            finish_run(workerID, id_tmp);
+            release_worker(workerID, worker);
+            if (gather)
+                gather_result(id_tmp);
+            if (share)
+                share_result(id_tmp);
+            if (batched)
+                split_batch(id_tmp);
+            finish_job(id_tmp);
+            release_dependents(id_tmp);
+            if (drop)
+                drop_job(id_tmp);
+        });
+        if (job.is_detached() || batched)
+            detached[id_tmp] = std::move(job);
+        else
+            futureMap[id_tmp] = std::move(job);
+    }
+
+    bool PoolImpl::is_speculative(const JobFuture &job) noexcept
+    {
+        return !job.is_detached() && job.get_spec().empty() && !job.get_template() &&
+            !job.has_gather() && !job.is_parent() && job.get_dependencies().empty() &&
+            !job.is_resident() && !job.has_actor() && job.get_storedInputs().empty();
+    }
+
+    void PoolImpl::finish_run(std::size_t workerID, JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+
+        // the job may run on an engine which is already replaced
+        auto it = draining.find(id);
+        bool current = workerID < running.size() && running[workerID].id == id;
+        if (!current && it == draining.end())
+            return; // e.g. the worker was removed
+        RunningJob &run = current ? running[workerID] : it->second;
+
+        if (!run.discard && !run.fun.empty())
+        {
+            std::chrono::duration<double> time = std::chrono::steady_clock::now() - run.start;
+            costs.add(run.fun, run.bytes, time.count());
+        }
+        if (run.lane < lanes.size())
+            --lanes[run.lane].running;
+
+        if (current)
+            run.reset();
+        else
+            draining.erase(it);
+    }
+
+    void PoolImpl::finish_job(JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+
+        resolve_speculation(id);
+
+        // clients wait for speculative jobs without blocking on the 
+        // future
+        if (speculation > 0)
+            cv_future.notify_all();
+
+        // the master may start a copy on this worker or a lane is 
+        // below its limit again
+        cv_queue.notify_one();
+    }
+
+    std::chrono::steady_clock::time_point PoolImpl::speculate()
+    {
+        auto next = std::chrono::steady_clock::time_point::max();
+        if (speculation <= 0 || lane_pending > 0 || !scheduler->empty())
+            return next;
+
+        // the slowest job compared to the median of its function
+        auto now = std::chrono::steady_clock::now();
+        std::size_t straggler = no_worker;
+        double ratio = 0;
+        for (std::size_t i = 0; i < running.size(); i++)
+        {
+            const RunningJob &run = running[i];
+            if (!run.speculative)
+                continue;
+            const RuntimeStats *stats = costs.get_stats(run.fun);
+            if (!stats || stats->count() < min_samples)
+                continue;
+
+            std::chrono::duration<double> limit(speculation * stats->median());
+            auto deadline = run.start + std::chrono::duration_cast<
+                std::chrono::steady_clock::duration>(limit);
+            if (deadline > now)
+            {
+                next = std::min(next, deadline);
+                continue;
+            }
+
+            std::chrono::duration<double> time = now - run.start;
+            double r = limit.count() > 0 ? time.count() / limit.count() : time.count();
+            if (straggler == no_worker || r > ratio)
+            {
+                straggler = i;
+                ratio = r;
+            }
+        }
+        if (straggler == no_worker)
+            return next;
+
+        // an idle worker, the master is woken up by the next finished
+        // job otherwise
+        std::size_t workerID = no_worker;
+        EngineHack *worker = nullptr;
+        {
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            for (std::size_t i = 0; i < engine.size() && i < running.size(); i++)
+            {
+                if (worker_ready[i])
+                {
+                    workerID = i;
+                    worker = engine[i].get();
+                    worker_ready[i] = false;
+                    break;
+                }
+            }
+        }
+        if (workerID == no_worker)
+            return std::chrono::steady_clock::time_point::max();
+
+        RunningJob &run = running[straggler];
+        run.speculative = false; // a single copy per job
+        JobFuture copy(JobFeval(run.fun, run.nlhs, std::vector<matlab::data::Array>(run.args)));
+        copy.set_detached();
+        speculative[copy.get_ID()] = run.id;
+        ++speculation_count;
+        start_job(copy, workerID, worker, false, no_lane);
+
+        return now; // check the other running jobs
+    }
+
+    void PoolImpl::resolve_speculation(JobID id) noexcept
+    {
+        // the copy is finished first
+        auto it = speculative.find(id);
+        if (it != speculative.end())
+        {
+            auto it_copy = detached.find(id);
+            auto it_job = futureMap.find(it->second);
+            speculative.erase(it);
+            if (it_copy == detached.end() || it_job == futureMap.end())
+                return; // e.g. the job is canceled
+
+            it_copy->second.wait();
+            if (it_copy->second.get_status() == JobFeval::Status::Done &&
+                it_job->second.get_status() == JobFeval::Status::InProgress)
+            {
+                // the worker has possibly not stored the arguments
+                std::size_t workerID = it_job->second.get_workerID();
+                if (!it_job->second.get_argDigests().empty())
+                {
+                    std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                    if (workerID < engine.size())
+                        engine[workerID]->reset_state();
+                }
+                discard_runtime(it_job->second);
+                it_job->second.adopt_result(it_copy->second);
+                ++speculation_wins;
+            }
+            return; // the copy is removed by its notifier
+        }
+
+        // the job is finished first (or canceled)
+        for (it = speculative.begin(); it != speculative.end(); ++it)
+        {
+            if (it->second != id)
+                continue;
+
+            auto it_copy = detached.find(it->first);
+            if (it_copy != detached.end())
+            {
+                discard_runtime(it_copy->second);
+                it_copy->second.cancel();
+            }
+            speculative.erase(it);
+            return;
+        }
+    }
+
+    void PoolImpl::discard_runtime(const JobFuture &job) noexcept
+    {
+        int workerID = job.get_workerID();
+        if (workerID >= 0 && std::size_t(workerID) < running.size() &&
+            running[workerID].id == job.get_ID())
+            running[workerID].discard = true;
+    }
+
+    void PoolImpl::autoscale()
+    {
+        using Clock = std::chrono::steady_clock;
+        using Seconds = std::chrono::duration<double>;
+
+        // begin of the current overload or idle period
+        Clock::time_point overload = Clock::time_point::max();
+        Clock::time_point idle = Clock::time_point::max();
+
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        while (!stop)
+        {
+            cv_scale.wait_for(lock_jobs, autoscale_interval);
+            if (stop)
+                break;
+
+            // engines which served too many jobs or grew too large
+            std::size_t retire = sleep ? no_worker : select_recycling();
+            if (retire != no_worker)
+            {
+                lock_jobs.unlock();
+                {
+                    std::unique_lock<std::mutex> lock_resize(mutex_resize);
+                    try
+                    {
+                        recycle_engine(retire);
+                    }
+                    catch (...)
+                    {
+                        // e.g. the engine could not be started, the next
+                        // check tries it again
+                    }
+                }
+                lock_jobs.lock();
+                continue;
+            }
+
+            lock_jobs.unlock();
+            close_retired();
+            lock_jobs.lock();
+            if (stop)
+                break;
+
+            if (autoscaling.minSize == 0 || sleep)
+            {
+                overload = idle = Clock::time_point::max();
+                continue;
+            }
+
+            // queued jobs and the age of the oldest one
+            auto now = Clock::now();
+            std::size_t depth = lane_pending;
+            Clock::time_point oldest = now;
+            for (const auto &queue : scheduler->get_queues())
+            {
+                depth += queue.size();
+                for (const auto &job : queue)
+                    oldest = std::min(oldest, job.get_submitTime());
+            }
+            for (std::size_t i = 1; i < lanes.size(); i++)
+                for (const auto &job : lanes[i].queue)
+                    oldest = std::min(oldest, job.get_submitTime());
+
+            std::size_t n, n_idle;
+            bool last_idle;
+            {
+                std::unique_lock<std::mutex> lock_worker(mutex_worker);
+                n = engine.size();
+                n_idle = std::size_t(std::count(worker_ready.begin(), worker_ready.end(), true));
+                last_idle = n > 0 && worker_ready.back() && 
+                    workerQueue.size() >= n && workerQueue[n - 1].empty();
+            }
+
+            // the results and actors of the last worker would be lost
+            if (last_idle && (holds_results(n - 1) || hosts_actors(n - 1)))
+                last_idle = false;
+
+            bool overloaded = depth > autoscaling.queueDepth * n ||
+                (depth > 0 && Seconds(now - oldest).count() > autoscaling.queueWait);
+            if (!overloaded)
+                overload = Clock::time_point::max();
+            else if (overload == Clock::time_point::max())
+                overload = now;
+            if (depth > 0 || n_idle < n)
+                idle = Clock::time_point::max();
+            else if (idle == Clock::time_point::max())
+                idle = now;
+
+            std::size_t target = n;
+            if (n < autoscaling.minSize)
+                target = autoscaling.minSize;
+            else if (n > autoscaling.maxSize && last_idle)
+                target = n - 1;
+            else if (overloaded && n < autoscaling.maxSize &&
+                Seconds(now - overload).count() >= autoscaling.sustain)
+            {
+                std::size_t perWorker = std::max(autoscaling.queueDepth, std::size_t(1));
+                target = std::min(autoscaling.maxSize,
+                    std::max(n + 1, (depth + perWorker - 1) / perWorker));
+            }
+            else if (n > autoscaling.minSize && last_idle && 
+                Seconds(now - idle).count() >= autoscaling.idleTimeout)
+                target = n - 1;
+
+            if (target == n)
+                continue;
+
+            // a resize may take some time (e.g. starting an engine), 
+            // the pool continues with the other jobs
+            lock_jobs.unlock();
+            bool done = false;
+            {
+                std::unique_lock<std::mutex> lock_resize(mutex_resize);
+                try
+                {
+                    done = resize_engines(unsigned(target), engineOptions, true);
+                }
+                catch (...)
+                {
+                    // e.g. the engine could not be started, the next 
+                    // check tries it again
+                }
+            }
+            lock_jobs.lock();
+
+            if (done && target > n)
+                ++scale_ups;
+            else if (done)
+                ++scale_downs;
+
+            // the next change needs a new sustained overload or idle 
+            // period, so the pool does not oscillate
+            overload = idle = Clock::time_point::max();
+        }
+    }
+
+    std::size_t PoolImpl::select_recycling()
+    {
+        if (recycle_jobs == 0 && recycle_memory == 0)
+            return no_worker;
+
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        for (std::size_t i = 0; i < engine.size() && i < served.size(); i++)
+        {
+            bool limit = (recycle_jobs > 0 && served[i] >= recycle_jobs) ||
+                (recycle_memory > 0 && engine[i]->get_memory() > recycle_memory);
+            if (limit && !holds_results(i) && !hosts_actors(i))
+                return i;
+        }
+        return no_worker;
+    }
+
+    bool PoolImpl::holds_results(std::size_t workerID) const noexcept
+    {
+        for (const auto &e : residents)
+            if (e.second == workerID)
+                return true;
+        for (const auto &e : stored)
+            if (e.second.workerID == workerID)
+                return true;
+        return false;
+    }
+
+    bool PoolImpl::hosts_actors(std::size_t workerID) const noexcept
+    {
+        for (const auto &e : actors)
+            if (e.second.workerID == workerID)
+                return true;
+        return false;
+    }
+
+    void PoolImpl::recycle_engine(std::size_t workerID)
+    {
+        // the worker continues with its jobs while the new engine starts
+        std::unique_lock<std::mutex> lock_init(mutex_init);
+        EnginePtr e = start_engine(engineOptions, workerID);
+
+        // a worker, which is reserved by the master, gets its job
+        // before the engines are swapped
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        for (;;)
+        {
+            if (stop || workerID >= engine.size() || holds_results(workerID) ||
+                hosts_actors(workerID))
+            {
+                // the new engine is closed without blocking the pool
+                lock_worker.unlock();
+                lock_jobs.unlock();
+                return;
+            }
+            if (worker_ready[workerID] || running[workerID].id != 0)
+                break;
+            lock_jobs.unlock();
+            cv_worker.wait_for(lock_worker, std::chrono::milliseconds(10));
+            lock_worker.unlock();
+            lock_jobs.lock();
+            lock_worker.lock();
+        }
+
+        // the job in progress is finished by the old engine
+        if (running[workerID].id != 0)
+        {
+            draining[running[workerID].id] = std::move(running[workerID]);
+            running[workerID] = RunningJob();
+        }
+
+        served[workerID] = 0;
+        ++recycled;
+
+        // the new engine takes the place of the old one immediately
+        engine[workerID].swap(e);
+        if (!worker_ready[workerID])
+        {
+            retired.push_back({ std::move(e), false });
+            worker_ready[workerID] = true;
+        }
+        cv_worker.notify_all();
+        lock_worker.unlock();
+        cv_queue.notify_one();
+        lock_jobs.unlock();
+
+        // an idle old engine is closed without blocking the pool
+        e.reset();
+    }
+
+    void PoolImpl::close_retired()
+    {
+        std::vector<EnginePtr> closing;
+        {
+            std::unique_lock<std::mutex> lock_worker(mutex_worker);
+            for (auto it = retired.begin(); it != retired.end();)
+            {
+                if (!it->idle)
+                {
+                    ++it;
+                    continue;
+                }
+                closing.push_back(std::move(it->engine));
+                it = retired.erase(it);
+            }
+        }
+        // the engines are closed without blocking the pool
+    }
+
+    void PoolImpl::release_worker(std::size_t workerID, const EngineHack *worker) noexcept
+    {
+        std::unique_lock<std::mutex> lock_worker(mutex_worker);
+        if (!worker || (workerID < engine.size() && engine[workerID].get() == worker))
+            worker_ready[workerID] = true;
+        else
+        {
+            // a replaced engine, it is closed by the autoscaler thread
+            for (auto &e : retired)
+                if (e.engine.get() == worker)
+                    e.idle = true;
+        }
+        cv_worker.notify_all(); // the master and a resize may wait
+    }
+
+    bool PoolImpl::exists(JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+
+        for (const auto &queue : scheduler->get_queues())
+            for (const auto &e : queue)
+                if (e.get_ID() == id && !e.is_detached())
+                    return true;
+
+        for (const auto &lane : lanes)
+            for (const auto &e : lane.queue)
+                if (e.get_ID() == id && !e.is_detached())
+                    return true;
+
+        for (const auto &e : futureMap)
+            if (e.first == id)
+                return true;
+
+        return blocked.count(id) > 0;
+    }
+
+    JobFuture *PoolImpl::find_job(JobID id) noexcept
+    {
+        for (auto &queue : scheduler->get_queues())
+            for (auto &e : queue)
+                if (e.get_ID() == id)
+                    return &e;
+
+        for (auto &lane : lanes)
+            for (auto &e : lane.queue)
+                if (e.get_ID() == id)
+                    return &e;
+
+        auto it = futureMap.find(id);
+        if (it != futureMap.end())
+            return &it->second;
+
+        auto it_detached = detached.find(id);
+        if (it_detached != detached.end())
+            return &it_detached->second;
+
+        for (auto &queue : workerQueue)
+            for (auto &e : queue)
+                if (e.get_ID() == id)
+                    return &e;
+
+        auto it_blocked = blocked.find(id);
+        if (it_blocked != blocked.end())
+            return &it_blocked->second;
+
+        return nullptr;
+    }
+
+    void PoolImpl::release_key(const JobFuture &job) noexcept
+    {
+        if (!job.has_jobKey())
+            return;
+
+        auto it = inflight.find(job.get_jobKey());
+        if (it != inflight.end() && it->second == job.get_ID())
+            inflight.erase(it);
+    }
+
+    void PoolImpl::share_result(JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+
+        auto it = futureMap.find(id);
+        if (it != futureMap.end())
+        {
+            it->second.wait();
+            share_result(it->second);
+            return;
+        }
+
+        // the leader was canceled, but it has followers
+        auto it_detached = detached.find(id);
+        if (it_detached != detached.end())
+        {
+            it_detached->second.wait();
+            share_result(it_detached->second);
+            detached.erase(it_detached);
+        }
+    }
+
+    void PoolImpl::share_result(JobFuture &leader) noexcept
+    {
+        release_key(leader);
+
+        // canceled followers are already removed
+        for (JobID follower : leader.pop_followers())
+        {
+            auto it = futureMap.find(follower);
+            if (it != futureMap.end() && it->second.is_pending())
+            {
+                it->second.share_result(leader);
+                if (it->second.is_parent())
+                    release_dependents(it->second);
+            }
+        }
+        cv_future.notify_all();
+    }
+
+    bool PoolImpl::is_batchable(const JobFuture &job, const JobFuture &first) noexcept
+    {
+        return job.get_spec().empty() && !job.has_gather() && !job.get_template() &&
+            !job.is_parent() && !job.is_resident() && job.get_dependencies().empty() &&
+            job.get_cmd() == first.get_cmd() &&
+            job.get_nlhs() == first.get_nlhs();
+    }
+
+    void PoolImpl::wait_batch(std::unique_lock<std::mutex> &lock_jobs)
+    {
+        while (!stop && !sleep && pinned_pending == 0)
+        {
+            // the jobs of the other lanes are not delayed
+            for (LaneID i = 1; i < lanes.size(); i++)
+                if (!lanes[i].queue.empty() && lanes[i].running < lane_limit(lanes[i]))
+                    return;
+
+            // the scheduler can be replaced during the wait
+            auto deadline = std::chrono::steady_clock::time_point::max();
+            for (const auto &queue : scheduler->get_queues())
+            {
+                if (queue.empty())
+                    continue;
+
+                const JobFuture &first = queue.front();
+                if (!is_batchable(first, first))
+                    return;
+
+                std::size_t n = 0;
+                for (const auto &e : queue)
+                    if (is_batchable(e, first) && ++n == batch_size)
+                        return;
+
+                // the window starts with the submission of the first job
+                auto end = first.get_submitTime() + batch_window;
+                if (std::chrono::steady_clock::now() >= end)
+                    return;
+                deadline = std::min(deadline, end);
+            }
+
+            if (deadline == std::chrono::steady_clock::time_point::max())
+                return;
+            cv_queue.wait_until(lock_jobs, deadline);
+        }
+    }
+
+    bool PoolImpl::make_batch(JobQueue &queue, JobFuture &batch)
+    {
+        const JobFuture &first = queue.front();
+        if (!is_batchable(first, first))
+            return false;
+
+        // indices of the jobs in the queue
+        std::vector<std::size_t> members;
+        for (std::size_t i = 0; i < queue.size() && members.size() < batch_size; i++)
+            if (is_batchable(queue[i], first))
+                members.push_back(i);
+        if (members.size() < 2)
+            return false;
+
+        // MatlabPoolWorker.batch(fun, nlhs, {args1, args2, ...})
+        auto args = factory.createCellArray({ 1, members.size() });
+        for (std::size_t i = 0; i < members.size(); i++)
+        {
+            auto &member_args = queue[members[i]].get_args();
+            auto tmp = factory.createCellArray({ 1, member_args.size() });
+            for (std::size_t j = 0; j < member_args.size(); j++)
+                tmp[j] = std::move(member_args[j]);
+            args[i] = std::move(tmp);
+        }
+
+        batch = JobFuture(JobFeval(batch_dispatcher, 2, {
+            factory.createCharArray(first.get_cmd()),
+            factory.createScalar<std::uint64_t>(first.get_nlhs()),
+            std::move(args) }));
+
+        // the members wait for the results of the batch
+        JobQueue rest;
+        for (std::size_t i = 0, k = 0; i < queue.size(); i++)
+        {
+            JobFuture &job = queue[i];
+            if (k == members.size() || members[k] != i)
+            {
+                rest.push_back(std::move(job));
+                continue;
+            }
+            ++k;
+
+            JobID id = job.get_ID();
+            batch.add_follower(id);
+            job.set_leader(batch.get_ID());
+            if (job.is_detached())
+                detached[id] = std::move(job);
+            else
+                futureMap[id] = std::move(job);
+        }
+        queue.swap(rest);
+
+        return true;
+    }
+
+    void PoolImpl::split_batch(JobID id) noexcept
+    {
+        std::unique_lock<std::mutex> lock_jobs(mutex_jobs);
+
+        auto it_batch = detached.find(id);
+        if (it_batch == detached.end())
+            return; // the pool is cleared
+        JobFuture batch = std::move(it_batch->second);
+        detached.erase(it_batch);
+        batch.wait();
+
+        bool ok = batch.get_status() == JobFeval::Status::Done;
+        matlab::data::CellArray results;
+        matlab::data::CellArray errors;
+        if (ok)
+        {
+            results = batch.peek_result()[0];
+            errors = batch.peek_result()[1];
+        }
+
+        std::vector<JobID> members = batch.pop_followers();
+        for (std::size_t i = 0; i < members.size(); i++)
+        {
+            bool isDetached = false;
+            auto it = futureMap.find(members[i]);
+            if (it == futureMap.end())
+            {
+                it = detached.find(members[i]);
+                isDetached = true;
+                if (it == detached.end())
+                    continue; // the job is canceled
+            }
+            JobFuture &member = it->second;
+
+            // the error of a job is a char array, otherwise empty
+            if (!ok)
+            {
+                member.set_error(batch.get_errBuf().str());
+            }
+            else if (errors[i].getType() == matlab::data::ArrayType::CHAR)
+            {
+                member.set_error(matlab::data::CharArray(errors[i]).toUTF16());
+            }
+            else
+            {
+                matlab::data::CellArray tmp = results[i];
+                std::vector<matlab::data::Array> result;
+                for (std::size_t j = 0; j < tmp.getNumberOfElements(); j++)
+                    result.push_back(tmp[j]);
+                member.set_result(std::move(result));
+            }
+
+            if (member.has_jobKey())
+                share_result(member);
+            if (member.is_parent())
+                release_dependents(member);
+            if (isDetached)
+                detached.erase(it);
+        }
+        cv_future.notify_all();
+    }
+
+    std::size_t PoolImpl::get_free_worker(std::unique_lock<std::mutex> &lock, bool any) noexcept
+    {
+        for (;;)
+        {
+            for (std::size_t i = 0; i < worker_ready.size() && i < preferred.size(); i++)
+                if (worker_ready[i] && preferred[i])
+                    return i;
+
+            if (any)
+            {
+                for (std::size_t i = 0; i < worker_ready.size(); i++)
+                    if (worker_ready[i])
+                        return i;
+            }
+
+            cv_worker.wait(lock);
+
+            // the queue may have changed
+            if (!any)
+                return no_worker;
         }
     }
 
@@ -1,6 +1,7 @@
 #ifndef MATLABPOOL_POOL_IMPL_HPP
 #define MATLABPOOL_POOL_IMPL_HPP
 
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <vector>
@@ -11,6 +12,9 @@
 #include "MatlabPool/Pool.hpp"
 #include "MatlabPoolLib/JobFuture.hpp"
 #include "MatlabPoolLib/EngineHack.hpp"
+#include "MatlabPoolLib/JobScheduler.hpp"
+#include "MatlabPoolLib/OutputSink.hpp"
+#include "MatlabPoolLib/ResultCache.hpp"
 
 namespace MatlabPool
 {
@@ -20,6 +24,106 @@ namespace MatlabPool
     class PoolImpl : public Pool
     {
         using EnginePtr = std::unique_ptr<EngineHack>;
+        using SinkPtr = std::unique_ptr<OutputSink>;
+        using GatherPtr = std::shared_ptr<GatherTarget>;
+        using TemplatePtr = std::shared_ptr<const JobTemplate>;
+
+        // return values of a job, which are stored by a worker for
+        // the jobs of a graph, "refs" counts the waiting arguments
+        struct StoredResult
+        {
+            std::size_t workerID;
+            std::size_t refs;
+        };
+
+        // constructor of an actor, it is evaluated again if the actor
+        // is moved to another worker or the engine is replaced
+        struct Actor
+        {
+            std::size_t workerID;
+            std::u16string fun;
+            std::vector<matlab::data::Array> args;
+        };
+
+        // map job of a reduction and its dependencies
+        struct MapJob
+        {
+            JobFuture job;
+            std::vector<JobDependency> deps;
+        };
+
+        // the nodes of the job containers are allocated by a "SlabPool"
+        using JobQueue = JobScheduler::JobQueue;
+        using JobMap = std::map<JobID, JobFuture, std::less<JobID>,
+            SlabAllocator<std::pair<const JobID, JobFuture>>>;
+
+        // job in progress on a worker, the function and the arguments
+        // are kept for a speculative copy of the job
+        struct RunningJob
+        {
+            JobID id = 0;
+            std::chrono::steady_clock::time_point start;
+            std::u16string fun;
+            std::size_t bytes = 0;
+            std::size_t nlhs = 0;
+            std::vector<matlab::data::Array> args;
+            bool speculative = false; // a copy of the job may be started
+            bool discard = false;     // canceled, the runtime is not recorded
+            LaneID lane = no_lane;    // e.g. no lane for pinned jobs
+
+            // clear the record, the memory of "fun" and "args" is kept
+            // for the next job
+            void reset() noexcept
+            {
+                id = 0;
+                fun.clear();
+                bytes = 0;
+                nlhs = 0;
+                args.clear();
+                speculative = false;
+                discard = false;
+                lane = no_lane;
+            }
+        };
+
+        // replaced engine, which finishes its last job (see 
+        // "recycle_engine")
+        struct Retired
+        {
+            EnginePtr engine;
+            bool idle = false;
+        };
+
+        // latency lane, the jobs of the default lane are queued by the
+        // scheduler
+        struct Lane
+        {
+            std::u16string name;
+            std::size_t reserved = 0;
+            double maxShare = 1.0;
+            JobQueue queue;
+            std::size_t running = 0;
+            std::uint64_t started = 0;
+            double waitSum = 0;     // seconds
+            double waitMax = 0;     // seconds
+        };
+
+        // step of the initialization profile
+        struct InitStep
+        {
+            std::u16string fun;
+            std::size_t nlhs;
+            std::vector<matlab::data::Array> args;
+        };
+
+        // worker side function for batches of jobs
+        inline static const std::u16string batch_dispatcher = u"MatlabPoolWorker.batch";
+
+        // worker side function for the reductions
+        inline static const std::u16string reduce_dispatcher = u"MatlabPoolWorker.reduce";
+
+        // worker side function for the actors
+        inline static const std::u16string actor_dispatcher = u"MatlabPoolWorker.actor";
 
     public:
         PoolImpl(const PoolImpl &) = delete;
@@ -28,7 +132,8 @@ namespace MatlabPool
         PoolImpl(unsigned int n, const std::vector<std::u16string> &options);
         ~PoolImpl() override;
 
-        // start or close matlab workers
+        // start or close matlab workers, the new engines are started
+        // without blocking the pool
         void resize(unsigned int n_new,
             const std::vector<std::u16string> &options) override;
 
@@ -45,33 +150,491 @@ namespace MatlabPool
 
         matlab::data::StructArray get_worker_status() override;
 
+        // counters of the pool, e.g. hits of the result cache
+        matlab::data::StructArray get_pool_status() override;
+
         void cancel(JobID jobID) override;
 
         // remove and cancel all jobs
         void clear() override;
 
+        // arguments with at least "threshold" bytes are cached by the
+        // workers, "capacity" is the cache size per worker in bytes
+        void set_argument_cache(std::size_t threshold,
+            std::size_t capacity) override;
+
+        // "capacity" of the memory tier in bytes, "directory" of the
+        // disk tier (empty for no disk tier)
+        void set_memoization(std::size_t capacity,
+            const std::u16string &directory) override;
+
+        // an empty function name removes all results
+        void invalidate_memoization(const std::u16string &fun) override;
+
+        // attach new jobs to identical jobs in the queue or in 
+        // progress instead of evaluating them twice
+        void set_coalescing(bool val) override;
+
+        // evaluate up to "size" queued jobs of the same function with
+        // a single call of the worker, the master waits up to "window"
+        // seconds (counted from the submission of the first job) for
+        // more jobs
+        void set_batching(std::size_t size, double window) override;
+
+        // the queued jobs are moved to the new scheduler
+        void set_scheduler(Scheduler type) override;
+
+        // the master checks the running jobs while the queues are
+        // empty, the median requires "min_samples" finished jobs
+        void set_speculation(double factor) override;
+
+        // a min size above the current size starts the workers 
+        // immediately
+        void set_autoscaling(const Autoscaling &val) override;
+
+        // the engines are checked by the autoscaler thread
+        void set_recycling(std::size_t maxJobs, std::size_t maxMemory) override;
+
+        // the running workers are bound immediately, their thread 
+        // budget changes with a pinned job
+        void set_cpu_pinning(bool enable, std::size_t cpusPerWorker,
+            bool numaSpread) override;
+
+        // the master takes the next job from the lanes below their 
+        // reservation, otherwise from the lane with the oldest job
+        LaneID add_lane(std::u16string name, std::size_t reserved,
+            double maxShare) override;
+        matlab::data::StructArray get_lane_status() override;
+
+        // the limit is applied to the jobs at the assignment to a worker
+        void set_output_limit(std::size_t limit) override;
+
+        // the output of coalesced or batched jobs is available only
+        // after the job is finished
+        std::u16string read_output(JobID id, bool error) override;
+
+        TemplateID register_template(std::u16string fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&fixedArgs) override;
+
+        // submit a job of a template with the varying arguments
+        JobID submit(TemplateID id, std::vector<matlab::data::Array> &&args) override;
+
+        void unregister_template(TemplateID id) override;
+
+        // the jobs of a broadcast are stored in the queues of the
+        // workers, the master prefers workers with such jobs
+        BroadcastID broadcast(std::u16string fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&args) override;
+
+        // wait for the jobs of all workers and remove the broadcast,
+        // the job of a removed worker gets an error
+        std::vector<JobFeval> wait_broadcast(BroadcastID id) override;
+
+        // the commands are evaluated by "evalin('base', cmd)"
+        BroadcastID add_init_eval(std::u16string cmd) override;
+        BroadcastID add_init_feval(std::u16string fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&args) override;
+        void clear_init() override;
+
+        // the job waits in "blocked" until its dependencies are 
+        // finished
+        JobID submit(JobFeval &&job, std::vector<JobDependency> &&deps) override;
+
+        // the worker which evaluates the job keeps the results, the 
+        // consumers of the results are queued for this worker
+        JobID submit_resident(JobFeval &&job) override;
+
+        // evaluates "MatlabPoolWorker.fetch_result" on the worker
+        std::vector<matlab::data::Array> fetch_result(JobID ref) override;
+
+        // the worker removes the results with its next job
+        void free_result(JobID ref) override;
+
+        // the map jobs are worker-resident jobs, the final job of the
+        // reduction waits for them in "blocked"
+        JobID map_reduce(std::u16string fun, std::u16string reduceFun,
+            std::vector<std::vector<matlab::data::Array>> &&inputs) override;
+
+        // the blocks are worker-resident results, they are evaluated
+        // by the first workers in the order of the blocks
+        DistributedID distribute(matlab::data::Array data, std::size_t dim) override;
+        BroadcastID spmd(DistributedID id, std::u16string fun,
+            std::size_t nlhs, std::vector<matlab::data::Array> &&args) override;
+        JobID spmd_reduce(DistributedID id, std::u16string fun,
+            std::u16string reduceFun, std::vector<matlab::data::Array> &&args) override;
+        void free_distributed(DistributedID id) override;
+
+        // the jobs of an actor are queued for its worker, so they are
+        // evaluated in order, the constructor prefers the worker with
+        // the fewest actors
+        ActorID create_actor(std::u16string fun,
+            std::vector<matlab::data::Array> &&args) override;
+        JobID call_actor(ActorID id, std::u16string method,
+            std::size_t nlhs, std::vector<matlab::data::Array> &&args) override;
+        matlab::data::Array fetch_actor(ActorID id) override;
+
+        // the worker removes the object with its next job
+        void destroy_actor(ActorID id) override;
+
+        SinkID create_sink(matlab::data::ArrayType type,
+            const std::vector<std::size_t> &dims) override;
+
+        JobID submit(JobFeval &&job, SinkID sink,
+            const Utilities::Slice &slice) override;
+
+        // wait for all jobs of the sink and remove the sink
+        matlab::data::Array wait_sink(SinkID sink) override;
+
+        GatherID create_gather(matlab::data::Array output,
+            std::vector<Utilities::Slice> slices) override;
+
+        JobID submit(JobFeval &&job, GatherID gather, std::size_t slot) override;
+
+        // wait for all jobs of the gather target and remove it
+        matlab::data::Array wait_gather(GatherID gather) override;
+
     private:
+        // start a matlab engine with the CPUs of the worker and 
+        // evaluate the initialization profile, mutex_init must be 
+        // locked (or rather the master thread is not started yet)
+        EnginePtr start_engine(const std::vector<std::u16string> &options,
+            std::size_t workerID);
+
+        // body of "resize", mutex_resize must be locked. With "keep"
+        // the workers are only removed if they hold no results, actors
+        // or pinned jobs (e.g. for the autoscaler), returns false if 
+        // the pool keeps its size
+        bool resize_engines(unsigned int n_new,
+            const std::vector<std::u16string> &options, bool keep = false);
+
+        // close the bookkeeping of the workers from "n" on: their 
+        // actors are moved, their pinned jobs get an error, mutex_jobs
+        // must be locked
+        void remove_workers(std::size_t n);
+
+        // loop of the autoscaler thread, it checks the queues and the
+        // engines every "autoscale_interval"
+        void autoscale();
+
+        // a worker whose engine should be replaced, "no_worker" if 
+        // there is none, mutex_jobs must be locked
+        std::size_t select_recycling();
+
+        // check if results are kept by a worker (they would be lost 
+        // with the engine), mutex_jobs must be locked
+        bool holds_results(std::size_t workerID) const noexcept;
+
+        // check if a worker hosts an actor (its state would be lost 
+        // with the engine), mutex_jobs must be locked
+        bool hosts_actors(std::size_t workerID) const noexcept;
+
+        // replace the engine of a worker: the new engine is started 
+        // first and takes the place of the old one immediately. A busy
+        // old engine finishes its job in the background and is closed
+        // by "close_retired". Nothing happens if the worker holds 
+        // results or actors meanwhile, mutex_resize must be locked
+        void recycle_engine(std::size_t workerID);
+
+        // close the retired engines which finished their last job, 
+        // mutex_jobs must not be locked
+        void close_retired();
+
+        // evaluate a step on the current workers and add it to the 
+        // profile if it succeeds, the jobs are not detached (the 
+        // client waits for the broadcast)
+        BroadcastID add_init_step(InitStep &&step);
+
+        // wait until the jobs of a broadcast are finished, they are 
+        // kept for "wait_broadcast". Returns false if a job failed or
+        // was removed, mutex_jobs must be locked
+        bool broadcast_succeeded(BroadcastID id, std::unique_lock<std::mutex> &lock_jobs);
+
+        // queue a job for the first "n" workers, mutex_jobs must be
+        // locked
+        BroadcastID queue_broadcast(const std::u16string &fun, std::size_t nlhs,
+            const std::vector<matlab::data::Array> &args, std::size_t n);
+
+        // wait for a job, which is not waited for by the client, e.g.
+        // a job of a broadcast, mutex_jobs must be locked
+        JobFeval take_job(JobID id, std::unique_lock<std::mutex> &lock_jobs);
+
+        // wake up the master after adding pinned jobs, mutex_jobs must
+        // be locked
+        void notify_pinned();
+
+        // rebuild the CPU layout for "n" workers if the pinning is 
+        // enabled, mutex_resize must be locked
+        void update_layout(std::size_t n);
+
+        // bind the workers to the CPU sets of the layout, mutex_jobs 
+        // and mutex_worker must be locked
+        void apply_layout(CpuLayout &&tmp);
+
+        // job for "MatlabPoolWorker.actor", e.g. a method call
+        JobFuture make_actor_job(const char *op, ActorID id,
+            const std::u16string &fun, std::size_t nlhs,
+            std::vector<matlab::data::Array> &&args);
+
+        // the worker with the fewest actors of the first "n" workers,
+        // mutex_jobs must be locked
+        std::size_t select_actor_worker(std::size_t n) const noexcept;
+
+        // construct the actor again on another worker and move its 
+        // queued jobs, mutex_jobs must be locked
+        void move_actor(ActorID id, Actor &actor, std::size_t workerID);
+
+        // remove a detached job, which is finished, e.g. a constructor
+        // replay, called by the notifier of the job
+        void drop_job(JobID id) noexcept;
+
+        // add a job to the job queue
+        JobID submit_job(JobFuture &&job);
+
+        // add a job with dependencies, the dependencies must exist, 
+        // mutex_jobs must be locked
+        JobID add_job(JobFuture &&tmp, std::vector<JobDependency> &&deps);
+
+        // add the map jobs and the final job of a reduction, mutex_jobs
+        // must be locked
+        JobID add_reduction(const std::u16string &reduceFun, std::vector<MapJob> &&parts);
+
+        // jobs "fun(block, args...)" for the blocks of a distributed
+        // array
+        std::vector<MapJob> make_block_jobs(const std::vector<JobID> &blocks,
+            const std::u16string &fun, std::size_t nlhs,
+            const std::vector<matlab::data::Array> &args);
+
+        // remove a worker-resident result, returns false if the result
+        // does not exist, mutex_jobs must be locked
+        bool release_resident(JobID ref) noexcept;
+
+        // replace the final job of a reduction by the reduction on the
+        // workers with the partial results, mutex_jobs must be locked
+        void expand_reduction(JobFuture &&job, const std::vector<JobID> &parts);
+
+        // remove the partial results of a failed or canceled 
+        // reduction, mutex_jobs must be locked
+        void drop_reduction(JobID id) noexcept;
+
+        // add a job of a graph, whose dependencies are finished, to 
+        // the job queue or to the queue of the worker with its
+        // worker-resident inputs, mutex_jobs must be locked
+        void release_job(JobFuture &&job);
+
+        // pass the results of a finished job to the jobs which depend
+        // on it, called by the notifier of the job
+        void release_dependents(JobID id) noexcept;
+
+        // mutex_jobs must be locked, the job must be finished
+        void release_dependents(JobFuture &parent) noexcept;
+
+        // fail a blocked job and its dependents, mutex_jobs must be
+        // locked
+        void fail_job(JobID id, const std::u16string &msg) noexcept;
+
+        // fail the dependents of a canceled job, mutex_jobs must be 
+        // locked
+        void fail_dependents(JobID id) noexcept;
+
+        // copy a return value of "parent" into an argument of "job"
+        // (or rather refer to a worker-resident result), returns false
+        // if the value does not exist, mutex_jobs must be locked
+        bool pass_result(JobFuture &job, const JobDependency &dep,
+            const JobFuture &parent);
+
+        // count the arguments of blocked jobs, which wait for the 
+        // results of a job, mutex_jobs must be locked
+        std::size_t count_refs(JobID id) const noexcept;
+
+        // the job does not need the stored results anymore, mutex_jobs
+        // must be locked
+        void unref_inputs(const JobFuture &job) noexcept;
+
+        // add a finished job, e.g. served by the result cache
+        JobID submit_done(JobFuture &&job);
+
+        // search a job in the queues, in the future map and in the
+        // detached jobs, mutex_jobs must be locked
+        JobFuture *find_job(JobID id) noexcept;
+
+        // remove the job from the in-flight jobs, mutex_jobs must be
+        // locked
+        void release_key(const JobFuture &job) noexcept;
+
+        // copy the results of a finished leader to its followers,
+        // called by the notifier of the job
+        void share_result(JobID id) noexcept;
+
+        // mutex_jobs must be locked
+        void share_result(JobFuture &leader) noexcept;
+
+        // check if "job" can be evaluated in one batch with "first"
+        static bool is_batchable(const JobFuture &job, const JobFuture &first) noexcept;
+
+        // wait until the batch window of the first job of a queue is
+        // over or a batch is full, called before a worker is reserved.
+        // Returns early for jobs of other lanes and pinned jobs, 
+        // mutex_jobs must be locked
+        void wait_batch(std::unique_lock<std::mutex> &lock_jobs);
+
+        // remove the jobs of the same function as the first job of the
+        // queue from the queue and create a batch job, mutex_jobs must
+        // be locked
+        bool make_batch(JobQueue &queue, JobFuture &batch);
+
+        // copy the results of a finished batch into its jobs, called
+        // by the notifier of the batch
+        void split_batch(JobID id) noexcept;
+
+        // copy the result of a finished job into its gather target,
+        // called by the notifier of the job
+        void gather_result(JobID id) noexcept;
+
+        // add a job to the scheduler or to the queue of its lane, 
+        // mutex_jobs must be locked
+        void queue_job(JobFuture &&job);
+
+        // number of workers a lane may use, mutex_jobs must be locked
+        std::size_t lane_limit(const Lane &lane) const noexcept;
+
+        // the lane of the next job for a free worker, "no_lane" if all
+        // lanes are empty or at their limit, mutex_jobs must be locked
+        LaneID select_lane(std::size_t workerID);
+
+        // check if a queued job of a lane can be assigned (except the
+        // pinned jobs), mutex_jobs must be locked
+        bool has_lane_jobs();
+
+        // evaluate a job on a worker, the job is moved into the future
+        // map (or into the detached jobs), "lane" is "no_lane" for 
+        // pinned jobs, mutex_jobs must be locked
+        void start_job(JobFuture &job, std::size_t workerID,
+            EngineHack *worker, bool batched, LaneID lane);
+
+        // check if a copy of the job may be evaluated, i.e. the job is
+        // a plain function call
+        static bool is_speculative(const JobFuture &job) noexcept;
+
+        // record the runtime of a finished job and close the record of
+        // the worker, called by the notifier of the job before the 
+        // worker is released (the master reuses the record afterwards)
+        void finish_run(std::size_t workerID, JobID id) noexcept;
+
+        // resolve the speculative copy of a finished job, called by the
+        // notifier of the job
+        void finish_job(JobID id) noexcept;
+
+        // start a copy of the slowest straggler on an idle worker,
+        // returns the time when the next running job becomes a 
+        // straggler, mutex_jobs must be locked
+        std::chrono::steady_clock::time_point speculate();
+
+        // the first finished copy of a job provides the results, the
+        // other copy is canceled, mutex_jobs must be locked
+        void resolve_speculation(JobID id) noexcept;
+
+        // the runtime of a canceled job is not recorded, mutex_jobs
+        // must be locked
+        void discard_runtime(const JobFuture &job) noexcept;
+
+        // mark a worker as ready, "worker" is the engine of the 
+        // finished job (nullptr for the current engine of the worker)
+        void release_worker(std::size_t workerID,
+            const EngineHack *worker = nullptr) noexcept;
+
         // check if a job exists
         bool exists(JobID id) noexcept;
 
-        // get free worker, possibly wait until a worker is ready
-        std::size_t get_free_worker(std::unique_lock<std::mutex> &lock) noexcept;
+        // get free worker, possibly wait until a worker is ready. 
+        // Workers with pinned jobs are preferred, the other workers
+        // are used only if "any" is set. Returns "no_worker" after a 
+        // wake up without a suitable worker
+        std::size_t get_free_worker(std::unique_lock<std::mutex> &lock, bool any) noexcept;
+
+        static constexpr std::size_t no_worker = std::size_t(-1);
+
+        static constexpr std::size_t min_samples = 5;
+
+        static constexpr LaneID no_lane = LaneID(-1);
+
+        static constexpr std::chrono::milliseconds autoscale_interval{ 250 };
 
     private:
         bool stop;                      // mutex_jobs
         bool sleep;                     // mutex_jobs
         std::vector<bool> worker_ready; // mutex_worker
         std::vector<EnginePtr> engine;  // mutex_worker
+        std::vector<Retired> retired;   // mutex_worker
 
         std::thread master;
+        std::thread scaler;
 
-        std::deque<JobFuture> jobQueue;      // mutex_jobs
-        std::map<JobID, JobFuture> futureMap; // mutex_jobs
+        bool coalesce;                  // mutex_jobs
+        std::size_t batch_size;         // mutex_jobs
+        std::chrono::steady_clock::duration batch_window; // mutex_jobs
+        std::size_t output_limit;       // mutex_jobs
+        std::size_t cache_threshold;    // mutex_jobs
+        std::size_t cache_capacity;     // mutex_worker
+        CpuLayout layout;               // mutex_worker
+        bool pinning;                   // mutex_worker
+        std::size_t pin_cpus;           // mutex_worker
+        bool pin_numa;                  // mutex_worker
+        std::vector<InitStep> initProfile; // mutex_init
+        std::vector<std::u16string> engineOptions; // mutex_resize
+        Autoscaling autoscaling;        // mutex_jobs
+        std::uint64_t scale_ups;        // mutex_jobs
+        std::uint64_t scale_downs;      // mutex_jobs
+        std::size_t recycle_jobs;       // mutex_jobs
+        std::size_t recycle_memory;     // mutex_jobs
+        std::uint64_t recycled;         // mutex_jobs
+        std::uint64_t passed_results;   // mutex_jobs, copied by the client
+
+        CostModel costs;                      // mutex_jobs
+        std::unique_ptr<JobScheduler> scheduler; // mutex_jobs
+        double speculation;                   // mutex_jobs
+        std::vector<RunningJob> running;      // mutex_jobs
+        std::vector<std::size_t> served;      // mutex_jobs, jobs per engine
+        std::map<JobID, RunningJob> draining; // mutex_jobs, jobs of retired engines
+        std::deque<Lane> lanes;               // mutex_jobs
+        std::size_t lane_pending;             // mutex_jobs
+        std::map<JobID, JobID> speculative;   // mutex_jobs, copy -> job
+        std::uint64_t speculation_count;      // mutex_jobs
+        std::uint64_t speculation_wins;       // mutex_jobs
+        JobMap futureMap;                     // mutex_jobs
+        JobMap detached;                      // mutex_jobs
+        std::map<Digest, JobID> inflight;     // mutex_jobs
+        std::deque<JobQueue> workerQueue;     // mutex_jobs
+        std::size_t pinned_pending;           // mutex_jobs
+        BroadcastID broadcast_count;          // mutex_jobs
+        std::map<BroadcastID, std::vector<JobID>> broadcasts; // mutex_jobs
+        std::vector<bool> preferred;          // master thread
+        JobMap blocked;                       // mutex_jobs
+        std::multimap<JobID, JobID> dependents; // mutex_jobs
+        std::map<JobID, StoredResult> stored; // mutex_jobs
+        std::map<JobID, std::size_t> residents; // mutex_jobs
+        std::map<JobID, std::vector<JobID>> reductions; // mutex_jobs
+        DistributedID distributed_count;      // mutex_jobs
+        std::map<DistributedID, std::vector<JobID>> distributed; // mutex_jobs
+        ActorID actor_count;                  // mutex_jobs
+        std::map<ActorID, Actor> actors;      // mutex_jobs
         std::condition_variable cv_queue;
         std::condition_variable cv_worker;
         std::condition_variable cv_future;
+        std::condition_variable cv_scale;
+        std::mutex mutex_resize;
+        std::mutex mutex_init;
         std::mutex mutex_jobs;
-        std::mutex mutex_worker;
+        mutable std::mutex mutex_worker;
+
+        ResultCache memo;
+
+        SinkID sink_count;                  // mutex_sinks
+        std::map<SinkID, SinkPtr> sinks;    // mutex_sinks
+        GatherID gather_count;              // mutex_sinks
+        std::map<GatherID, GatherPtr> gathers; // mutex_sinks
+        TemplateID template_count;          // mutex_sinks
+        std::map<TemplateID, TemplatePtr> templates; // mutex_sinks
+        std::mutex mutex_sinks;
 
         matlab::data::ArrayFactory factory;
     };
@@ -0,0 +1,300 @@
+#include "MatlabPoolLib/ResultCache.hpp"
+
+#include "MatlabPool/StreamBuf.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace MatlabPool
+{
+    namespace
+    {
+        namespace fs = std::filesystem;
+
+        constexpr std::uint64_t file_magic = 0x31435250424d504dULL; // "MPMBPRC1"
+        constexpr const char *file_extension = ".mpr";
+
+        class FileWriter : public Serializer::Writer
+        {
+        public:
+            FileWriter(const std::string &path)
+                : file(path, std::ios::binary | std::ios::trunc) {}
+
+            void write(const void *data, std::size_t n) override
+            {
+                file.write(static_cast<const char *>(data), std::streamsize(n));
+            }
+
+            bool good() const { return file.good(); }
+
+        private:
+            std::ofstream file;
+        };
+
+        class FileReader : public Serializer::Reader
+        {
+        public:
+            FileReader(const std::string &path)
+                : file(path, std::ios::binary) {}
+
+            void read(void *data, std::size_t n) override
+            {
+                if (!file.read(static_cast<char *>(data), std::streamsize(n)))
+                    throw Serializer::InvalidData();
+            }
+
+            bool good() const { return file.good(); }
+
+        private:
+            std::ifstream file;
+        };
+
+        std::size_t get_bytes(const ResultCache::Result &result) noexcept
+        {
+            std::size_t n = 0;
+            for (const auto &e : result)
+                n += Serializer::get_bytes(e);
+            return n;
+        }
+    } // namespace
+
+    ResultCache::ResultCache() noexcept
+        : bytes(0),
+        capacity(0),
+        hits(0),
+        misses(0)
+    {
+    }
+
+    void ResultCache::configure(std::size_t val, std::string dir)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        capacity = val;
+        directory = std::move(dir);
+        shrink();
+    }
+
+    bool ResultCache::enabled() noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return capacity > 0 || !directory.empty();
+    }
+
+    bool ResultCache::get_key(JobFeval &job, Digest &key)
+    {
+        try
+        {
+            Hasher hasher;
+            Serializer::write(hasher, job.get_cmd());
+            Serializer::write(hasher, std::uint64_t(job.get_nlhs()));
+            for (const auto &arg : job.get_args())
+                Serializer::write(hasher, arg);
+            key = hasher.get_digest();
+            return true;
+        }
+        catch (const Utilities::UnsupportedType &)
+        {
+            return false;
+        }
+    }
+
+    bool ResultCache::lookup(const std::u16string &fun, const Digest &key, Result &result)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // memory tier
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second->fun == fun)
+        {
+            lru.splice(lru.begin(), lru, it->second);
+            result = it->second->result;
+            ++hits;
+            return true;
+        }
+
+        // disk tier
+        std::string dir = directory;
+        lock.unlock();
+        bool found = !dir.empty() && read_file(dir, fun, key, result);
+        lock.lock();
+
+        if (found)
+        {
+            ++hits;
+            insert_memory({ key, fun, result, get_bytes(result) });
+        }
+        else
+        {
+            ++misses;
+        }
+        return found;
+    }
+
+    void ResultCache::insert(const std::u16string &fun, const Digest &key, const Result &result)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::string dir = directory;
+        insert_memory({ key, fun, result, get_bytes(result) });
+        lock.unlock();
+
+        if (!dir.empty())
+            write_file(dir, fun, key, result);
+    }
+
+    void ResultCache::invalidate(const std::u16string &fun)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (auto it = lru.begin(); it != lru.end();)
+        {
+            if (fun.empty() || it->fun == fun)
+            {
+                bytes -= it->bytes;
+                entries.erase(it->key);
+                it = lru.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        std::string dir = directory;
+        lock.unlock();
+
+        if (dir.empty())
+            return;
+
+        // remove only the files of the cache, the directory can
+        // contain other files
+        std::error_code ec;
+        std::vector<fs::path> subdirs;
+        if (fun.empty())
+        {
+            for (const auto &e : fs::directory_iterator(dir, ec))
+                if (e.is_directory(ec))
+                    subdirs.push_back(e.path());
+        }
+        else
+        {
+            subdirs.push_back(fs::path(dir) / convertUTF16StringToASCIIString(fun));
+        }
+
+        for (const auto &subdir : subdirs)
+        {
+            std::vector<fs::path> files;
+            for (const auto &e : fs::directory_iterator(subdir, ec))
+                if (e.path().extension() == file_extension)
+                    files.push_back(e.path());
+            for (const auto &f : files)
+                fs::remove(f, ec);
+            fs::remove(subdir, ec); // fails if the directory is not empty
+        }
+    }
+
+    ResultCache::Stats ResultCache::get_stats() noexcept
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return { hits, misses, entries.size(), bytes };
+    }
+
+    void ResultCache::shrink()
+    {
+        while (bytes > capacity)
+        {
+            const Entry &e = lru.back();
+            bytes -= e.bytes;
+            entries.erase(e.key);
+            lru.pop_back();
+        }
+    }
+
+    void ResultCache::insert_memory(Entry &&entry)
+    {
+        if (entry.bytes > capacity)
+            return;
+
+        auto it = entries.find(entry.key);
+        if (it != entries.end())
+        {
+            bytes -= it->second->bytes;
+            lru.erase(it->second);
+            entries.erase(it);
+        }
+
+        bytes += entry.bytes;
+        lru.push_front(std::move(entry));
+        entries[lru.front().key] = lru.begin();
+        shrink();
+    }
+
+    std::string ResultCache::get_path(const std::string &dir,
+        const std::u16string &fun, const Digest &key)
+    {
+        fs::path path = fs::path(dir) / convertUTF16StringToASCIIString(fun);
+        path /= key.to_string() + file_extension;
+        return path.string();
+    }
+
+    bool ResultCache::read_file(const std::string &dir, const std::u16string &fun,
+        const Digest &key, Result &result) noexcept
+    {
+        std::string path = get_path(dir, fun, key);
+        try
+        {
+            FileReader reader(path);
+            if (!reader.good())
+                return false;
+
+            if (Serializer::read_uint64(reader) != file_magic ||
+                Serializer::read_string(reader) != fun)
+                throw Serializer::InvalidData();
+
+            Result tmp(Serializer::read_uint64(reader));
+            for (auto &e : tmp)
+                e = Serializer::read_array(reader);
+
+            result = std::move(tmp);
+            return true;
+        }
+        catch (...)
+        {
+            // e.g. a file of an older version or an incomplete file
+            std::error_code ec;
+            fs::remove(path, ec);
+            return false;
+        }
+    }
+
+    void ResultCache::write_file(const std::string &dir, const std::u16string &fun,
+        const Digest &key, const Result &result) noexcept
+    {
+        std::string path = get_path(dir, fun, key);
+        std::string tmp_path = path + ".tmp";
+        std::error_code ec;
+        try
+        {
+            fs::create_directories(fs::path(path).parent_path(), ec);
+            {
+                FileWriter writer(tmp_path);
+                Serializer::write(writer, file_magic);
+                Serializer::write(writer, fun);
+                Serializer::write(writer, std::uint64_t(result.size()));
+                for (const auto &e : result)
+                    Serializer::write(writer, e);
+                if (!writer.good())
+                    throw Serializer::InvalidData();
+            }
+
+            // the rename is atomic, so other pools never read an 
+            // incomplete file
+            fs::rename(tmp_path, path, ec);
+            if (ec)
+                fs::remove(tmp_path, ec);
+        }
+        catch (...)
+        {
+            // e.g. an unsupported result type, the result is not stored
+            fs::remove(tmp_path, ec);
+        }
+    }
+
+} // namespace MatlabPool
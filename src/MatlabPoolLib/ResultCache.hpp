@@ -0,0 +1,100 @@
+#ifndef MATLABPOOL_RESULTCACHE_HPP
+#define MATLABPOOL_RESULTCACHE_HPP
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MatlabPool/JobFeval.hpp"
+#include "MatlabPool/Serializer.hpp"
+
+namespace MatlabPool
+{
+    // Memoization of job results. The key of a job is the hash of 
+    // its function name, the number of return values and the content
+    // of its arguments. The results are stored in a memory tier 
+    // (least recently used entries are removed if the capacity is 
+    // exceeded) and optional in a disk tier, i.e. one file per 
+    // result in a subdirectory per function. The disk tier survives
+    // a restart of the pool.
+    class ResultCache
+    {
+    public:
+        using Result = std::vector<matlab::data::Array>;
+
+        struct Stats
+        {
+            std::uint64_t hits;
+            std::uint64_t misses;
+            std::uint64_t entries;
+            std::uint64_t bytes;
+        };
+
+    private:
+        struct Entry
+        {
+            Digest key;
+            std::u16string fun;
+            Result result;
+            std::size_t bytes;
+        };
+
+    public:
+        ResultCache(const ResultCache &) = delete;
+        ResultCache &operator=(const ResultCache &) = delete;
+
+        ResultCache() noexcept;
+
+        // capacity of the memory tier in bytes and directory of the 
+        // disk tier (empty for no disk tier). The cache is disabled
+        // if both are zero/empty
+        void configure(std::size_t capacity, std::string directory);
+
+        bool enabled() noexcept;
+
+        // compute the key of a job, returns false if the job can not
+        // be memoized (e.g. an argument is an object)
+        static bool get_key(JobFeval &job, Digest &key);
+
+        // get the results of a job, counts hits and misses
+        bool lookup(const std::u16string &fun, const Digest &key, Result &result);
+
+        void insert(const std::u16string &fun, const Digest &key, const Result &result);
+
+        // remove all results of a function, an empty name removes
+        // all results
+        void invalidate(const std::u16string &fun);
+
+        Stats get_stats() noexcept;
+
+    private:
+        // remove entries until the size fits the capacity
+        void shrink();
+
+        // add an entry to the memory tier
+        void insert_memory(Entry &&entry);
+
+        // disk tier, "dir" is a copy of "directory"
+        static std::string get_path(const std::string &dir,
+            const std::u16string &fun, const Digest &key);
+        static bool read_file(const std::string &dir, const std::u16string &fun,
+            const Digest &key, Result &result) noexcept;
+        static void write_file(const std::string &dir, const std::u16string &fun,
+            const Digest &key, const Result &result) noexcept;
+
+    private:
+        std::list<Entry> lru;                                   // mutex
+        std::map<Digest, std::list<Entry>::iterator> entries;   // mutex
+        std::size_t bytes;                                      // mutex
+        std::size_t capacity;                                   // mutex
+        std::string directory;                                  // mutex
+        std::uint64_t hits;                                     // mutex
+        std::uint64_t misses;                                   // mutex
+        std::mutex mutex;
+    };
+
+} // namespace MatlabPool
+
+#endif
@@ -0,0 +1,36 @@
+#include "MatlabPoolLib/RuntimeStats.hpp"
+
+#include <algorithm>
+
+namespace MatlabPool
+{
+    RuntimeStats::RuntimeStats() noexcept : next(0)
+    {
+    }
+
+    void RuntimeStats::add(double seconds)
+    {
+        if (samples.size() < capacity)
+            samples.push_back(seconds);
+        else
+            samples[next] = seconds;
+        next = (next + 1) % capacity;
+    }
+
+    std::size_t RuntimeStats::count() const noexcept
+    {
+        return samples.size();
+    }
+
+    double RuntimeStats::median() const
+    {
+        if (samples.empty())
+            return 0.0;
+
+        std::vector<double> tmp(samples);
+        auto mid = tmp.begin() + tmp.size() / 2;
+        std::nth_element(tmp.begin(), mid, tmp.end());
+        return *mid;
+    }
+
+} // namespace MatlabPool
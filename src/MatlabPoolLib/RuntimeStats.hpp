@@ -0,0 +1,34 @@
+#ifndef MATLABPOOL_RUNTIMESTATS_HPP
+#define MATLABPOOL_RUNTIMESTATS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace MatlabPool
+{
+    // Runtimes of the last jobs of a single function in seconds. The
+    // samples are stored in a ring buffer, so the statistics follow
+    // changes of the workload.
+    class RuntimeStats
+    {
+    public:
+        static constexpr std::size_t capacity = 32;
+
+        RuntimeStats() noexcept;
+
+        void add(double seconds);
+
+        // number of stored samples (at most "capacity")
+        std::size_t count() const noexcept;
+
+        // median of the stored samples, zero without samples
+        double median() const;
+
+    private:
+        std::vector<double> samples;
+        std::size_t next;
+    };
+
+} // namespace MatlabPool
+
+#endif
@@ -101,7 +101,9 @@ void MexFunction::resize(ArgumentList &outputs, ArgumentList &inputs)
     if (!pool)
     {
         using namespace MatlabPool;
-        pool = std::unique_ptr<Pool>(PoolLibLoader::createPool(nof_worker, options));
+        auto &tmp = pools[poolName];
+        tmp = std::unique_ptr<Pool>(PoolLibLoader::createPool(nof_worker, options));
+        pool = tmp.get();
     }
     else
         pool->resize(nof_worker, options);
@@ -202,3 +204,760 @@ void MexFunction::clear(ArgumentList &outputs, ArgumentList &inputs)
     if (pool)
         pool->clear();
 }
+
+void MexFunction::createSink(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::string className = ((matlab::data::CharArray)inputs[1]).toAscii();
+
+    SinkID sink = pool->create_sink(Utilities::get_arrayType(className),
+        get_vector<std::size_t>(inputs[2]));
+    outputs[0] = factory.createScalar<SinkID>(sink);
+}
+
+void MexFunction::submitSink(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 5)
+        throw InvalidInputSize(inputs.size());
+
+    Utilities::Slice slice{ get_vector<std::size_t>(inputs[2]),
+        get_vector<std::size_t>(inputs[3]) };
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[4]).toUTF16();
+
+    JobID jobid = pool->submit(JobFeval(std::move(funname), 0,
+        { inputs.begin() + 5, inputs.end() }),
+        get_scalar<SinkID>(inputs[1]), slice);
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::waitSink(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    outputs[0] = pool->wait_sink(get_scalar<SinkID>(inputs[1]));
+}
+
+void MexFunction::createGather(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 5)
+        throw InvalidInputSize(inputs.size());
+
+    std::string className = ((matlab::data::CharArray)inputs[1]).toAscii();
+    std::vector<std::size_t> dims = get_vector<std::size_t>(inputs[2]);
+
+    // one row of "offset" and "size" for each slice
+    std::vector<std::size_t> offset = get_vector<std::size_t>(inputs[3]);
+    std::vector<std::size_t> size = get_vector<std::size_t>(inputs[4]);
+    std::size_t n = inputs[3].getDimensions()[0];
+    if (offset.size() != n * dims.size())
+        throw InvalidParameterSize(inputs[3].getDimensions());
+    if (size.size() != n * dims.size())
+        throw InvalidParameterSize(inputs[4].getDimensions());
+
+    std::vector<Utilities::Slice> slices(n);
+    for (std::size_t i = 0; i < n; i++)
+        for (std::size_t k = 0; k < dims.size(); k++)
+        {
+            slices[i].offset.push_back(offset[i + k * n]);
+            slices[i].dims.push_back(size[i + k * n]);
+        }
+
+    matlab::data::Array output = Utilities::visitNumeric(
+        Utilities::get_arrayType(className), [&](auto *p) -> matlab::data::Array {
+            using T = std::remove_pointer_t<decltype(p)>;
+            return factory.createArray<T>(dims);
+        });
+
+    GatherID gather = pool->create_gather(std::move(output), std::move(slices));
+    outputs[0] = factory.createScalar<GatherID>(gather);
+}
+
+void MexFunction::submitGather(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    // matlab indices start with one
+    std::size_t slot = get_scalar<std::size_t>(inputs[2]) - 1;
+    std::u16string funname = ((matlab::data::CharArray)inputs[3]).toUTF16();
+
+    JobID jobid = pool->submit(JobFeval(std::move(funname), 1,
+        { inputs.begin() + 4, inputs.end() }),
+        get_scalar<GatherID>(inputs[1]), slot);
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::waitGather(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    outputs[0] = pool->wait_gather(get_scalar<GatherID>(inputs[1]));
+}
+
+void MexFunction::argumentCache(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_argument_cache(get_scalar<std::uint64_t>(inputs[1]),
+        get_scalar<std::uint64_t>(inputs[2]));
+}
+
+void MexFunction::statusPool(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 1)
+        throw InvalidInputSize(inputs.size());
+
+    outputs[0] = pool->get_pool_status();
+}
+
+void MexFunction::memoize(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string directory = ((matlab::data::CharArray)inputs[2]).toUTF16();
+    pool->set_memoization(get_scalar<std::uint64_t>(inputs[1]), directory);
+}
+
+void MexFunction::invalidateMemo(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->invalidate_memoization(((matlab::data::CharArray)inputs[1]).toUTF16());
+}
+
+void MexFunction::coalesce(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_coalescing(get_scalar<bool>(inputs[1]));
+}
+
+void MexFunction::batching(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_batching(get_scalar<std::uint64_t>(inputs[1]),
+        get_scalar<double>(inputs[2]));
+}
+
+void MexFunction::registerTemplate(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+    TemplateID id = pool->register_template(std::move(funname),
+        get_scalar<std::size_t>(inputs[2]), { inputs.begin() + 3, inputs.end() });
+    outputs[0] = factory.createScalar<TemplateID>(id);
+}
+
+void MexFunction::submitTemplate(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 2)
+        throw InvalidInputSize(inputs.size());
+
+    JobID jobid = pool->submit(get_scalar<TemplateID>(inputs[1]),
+        { inputs.begin() + 2, inputs.end() });
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::unregisterTemplate(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->unregister_template(get_scalar<TemplateID>(inputs[1]));
+}
+
+void MexFunction::submitQuiet(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+
+    // the error messages are still captured
+    JobFeval job(std::move(funname),
+        get_scalar<std::size_t>(inputs[2]),
+        { inputs.begin() + 3, inputs.end() });
+    job.set_capture(false, true);
+
+    JobID jobid = pool->submit(std::move(job));
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::outputLimit(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_output_limit(get_scalar<std::uint64_t>(inputs[1]));
+}
+
+void MexFunction::readOutput(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    outputs[0] = factory.createCharArray(pool->read_output(
+        get_scalar<JobID>(inputs[1]), get_scalar<bool>(inputs[2])));
+}
+
+void MexFunction::broadcast(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+
+    BroadcastID id = pool->broadcast(std::move(funname),
+        get_scalar<std::size_t>(inputs[2]),
+        { inputs.begin() + 3, inputs.end() });
+    outputs[0] = factory.createScalar<BroadcastID>(id);
+}
+
+void MexFunction::waitBroadcast(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    std::vector<JobFeval> jobs = pool->wait_broadcast(get_scalar<BroadcastID>(inputs[1]));
+
+    // one struct (like "wait") for each worker
+    auto result = factory.createCellArray({ 1, jobs.size() });
+    for (std::size_t i = 0; i < jobs.size(); i++)
+        result[i] = jobs[i].toStruct();
+    outputs[0] = std::move(result);
+}
+
+void MexFunction::initEval(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    BroadcastID id = pool->add_init_eval(((matlab::data::CharArray)inputs[1]).toUTF16());
+    outputs[0] = factory.createScalar<BroadcastID>(id);
+}
+
+void MexFunction::initFeval(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+
+    BroadcastID id = pool->add_init_feval(std::move(funname),
+        get_scalar<std::size_t>(inputs[2]),
+        { inputs.begin() + 3, inputs.end() });
+    outputs[0] = factory.createScalar<BroadcastID>(id);
+}
+
+void MexFunction::clearInit(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 1)
+        throw InvalidInputSize(inputs.size());
+
+    pool->clear_init();
+}
+
+void MexFunction::submitAfter(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::vector<JobDependency> deps;
+    for (JobID id : get_vector<JobID>(inputs[1]))
+        deps.push_back({ id, JobDependency::none, JobDependency::none });
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[2]).toUTF16();
+
+    // placeholders: struct('MatlabPoolOutput',uint64([jobid k]))
+    std::vector<matlab::data::Array> args(inputs.begin() + 4, inputs.end());
+    for (std::size_t i = 0; i < args.size(); i++)
+    {
+        if (args[i].getType() != matlab::data::ArrayType::STRUCT ||
+            args[i].getNumberOfElements() != 1)
+            continue;
+        matlab::data::StructArray st = args[i];
+        auto names = st.getFieldNames();
+        if (std::distance(names.begin(), names.end()) != 1 ||
+            std::string(*names.begin()) != "MatlabPoolOutput")
+            continue;
+
+        auto ref = get_vector<std::uint64_t>(st[0]["MatlabPoolOutput"]);
+        if (ref.size() != 2 || ref[1] == 0)
+            throw InvalidParameterSize(st[0]["MatlabPoolOutput"].getDimensions());
+        deps.push_back({ ref[0], ref[1] - 1, i });
+    }
+
+    JobID jobid = pool->submit(JobFeval(std::move(funname),
+        get_scalar<std::size_t>(inputs[3]), std::move(args)), std::move(deps));
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::submitResident(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+
+    JobID jobid = pool->submit_resident(JobFeval(std::move(funname),
+        get_scalar<std::size_t>(inputs[2]),
+        { inputs.begin() + 3, inputs.end() }));
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::fetchResult(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    auto result = pool->fetch_result(get_scalar<JobID>(inputs[1]));
+    auto cell = factory.createCellArray({ 1, result.size() });
+    for (std::size_t i = 0; i < result.size(); i++)
+        cell[i] = std::move(result[i]);
+    outputs[0] = std::move(cell);
+}
+
+void MexFunction::freeResult(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->free_result(get_scalar<JobID>(inputs[1]));
+}
+
+void MexFunction::createActor(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 2)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+
+    ActorID id = pool->create_actor(std::move(funname),
+        { inputs.begin() + 2, inputs.end() });
+    outputs[0] = factory.createScalar<ActorID>(id);
+}
+
+void MexFunction::callActor(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string method = ((matlab::data::CharArray)inputs[2]).toUTF16();
+
+    JobID jobid = pool->call_actor(get_scalar<ActorID>(inputs[1]),
+        std::move(method), get_scalar<std::size_t>(inputs[3]),
+        { inputs.begin() + 4, inputs.end() });
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::fetchActor(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    outputs[0] = pool->fetch_actor(get_scalar<ActorID>(inputs[1]));
+}
+
+void MexFunction::destroyActor(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->destroy_actor(get_scalar<ActorID>(inputs[1]));
+}
+
+void MexFunction::mapReduce(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[1]).toUTF16();
+    std::u16string reducename = ((matlab::data::CharArray)inputs[2]).toUTF16();
+
+    // every cell is the argument list of a map job
+    matlab::data::CellArray cell = inputs[3];
+    std::vector<std::vector<matlab::data::Array>> args;
+    args.reserve(cell.getNumberOfElements());
+    for (matlab::data::Array e : cell)
+    {
+        if (e.getType() == matlab::data::ArrayType::CELL)
+        {
+            matlab::data::CellArray list = e;
+            args.emplace_back(list.begin(), list.end());
+        }
+        else
+            args.push_back({ e });
+    }
+
+    JobID jobid = pool->map_reduce(std::move(funname), std::move(reducename),
+        std::move(args));
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::distribute(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    // the dimension is one based
+    std::size_t dim = get_scalar<std::size_t>(inputs[2]);
+    if (dim == 0)
+        throw Pool::InvalidSlice();
+
+    DistributedID id = pool->distribute(inputs[1], dim - 1);
+    outputs[0] = factory.createScalar<DistributedID>(id);
+}
+
+void MexFunction::spmd(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[2]).toUTF16();
+
+    BroadcastID id = pool->spmd(get_scalar<DistributedID>(inputs[1]),
+        std::move(funname), get_scalar<std::size_t>(inputs[3]),
+        { inputs.begin() + 4, inputs.end() });
+    outputs[0] = factory.createScalar<BroadcastID>(id);
+}
+
+void MexFunction::spmdReduce(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[2]).toUTF16();
+    std::u16string reducename = ((matlab::data::CharArray)inputs[3]).toUTF16();
+
+    JobID jobid = pool->spmd_reduce(get_scalar<DistributedID>(inputs[1]),
+        std::move(funname), std::move(reducename),
+        { inputs.begin() + 4, inputs.end() });
+    outputs[0] = factory.createScalar<JobID>(jobid);
+}
+
+void MexFunction::freeDistributed(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->free_distributed(get_scalar<DistributedID>(inputs[1]));
+}
+
+void MexFunction::scheduler(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    // unknown types select the central scheduler
+    pool->set_scheduler(static_cast<Pool::Scheduler>(get_scalar<std::uint8_t>(inputs[1])));
+}
+
+void MexFunction::speculation(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_speculation(get_scalar<double>(inputs[1]));
+}
+
+void MexFunction::submitCost(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[2]).toUTF16();
+
+    JobFeval job(std::move(funname), get_scalar<std::size_t>(inputs[3]),
+        { inputs.begin() + 4, inputs.end() });
+    job.set_cost(get_scalar<double>(inputs[1]));
+    outputs[0] = factory.createScalar<JobID>(pool->submit(std::move(job)));
+}
+
+void MexFunction::addLane(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string name = ((matlab::data::CharArray)inputs[1]).toUTF16();
+
+    LaneID id = pool->add_lane(std::move(name), get_scalar<std::size_t>(inputs[2]),
+        get_scalar<double>(inputs[3]));
+    outputs[0] = factory.createScalar<LaneID>(id);
+}
+
+void MexFunction::submitLane(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() < 4)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string funname = ((matlab::data::CharArray)inputs[2]).toUTF16();
+
+    JobFeval job(std::move(funname), get_scalar<std::size_t>(inputs[3]),
+        { inputs.begin() + 4, inputs.end() });
+    job.set_lane(get_scalar<LaneID>(inputs[1]));
+    outputs[0] = factory.createScalar<JobID>(pool->submit(std::move(job)));
+}
+
+void MexFunction::statusLanes(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 1)
+        throw InvalidInputSize(inputs.size());
+
+    outputs[0] = pool->get_lane_status();
+}
+
+void MexFunction::onPool(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (inputs.size() < 3)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string name = ((matlab::data::CharArray)inputs[1]).toUTF16();
+    MexCommands::CmdID id = get_scalar<MexCommands::CmdID>(inputs[2]);
+
+    // the command is evaluated with the named pool, its inputs start
+    // with the command id
+    ArgumentList cmdInputs(inputs.begin() + 2, inputs.end(), inputs.size() - 2);
+
+    std::u16string previous = poolName;
+    select_pool(std::move(name));
+    try
+    {
+        (this->*MexCommands::get_fun(id))(outputs, cmdInputs);
+    }
+    catch (...)
+    {
+        select_pool(std::move(previous));
+        throw;
+    }
+    select_pool(std::move(previous));
+}
+
+void MexFunction::closePool(ArgumentList &outputs, ArgumentList &inputs)
+{
+    if (inputs.size() != 2)
+        throw InvalidInputSize(inputs.size());
+
+    std::u16string name = ((matlab::data::CharArray)inputs[1]).toUTF16();
+    if (name == poolName)
+        pool = nullptr;
+    pools.erase(name);
+}
+
+void MexFunction::select_pool(std::u16string name)
+{
+    auto it = pools.find(name);
+    pool = it != pools.end() ? it->second.get() : nullptr;
+    poolName = std::move(name);
+}
+
+void MexFunction::autoscale(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 7)
+        throw InvalidInputSize(inputs.size());
+
+    Pool::Autoscaling val;
+    val.minSize = get_scalar<std::size_t>(inputs[1]);
+    val.maxSize = get_scalar<std::size_t>(inputs[2]);
+    val.queueDepth = get_scalar<std::size_t>(inputs[3]);
+    val.queueWait = get_scalar<double>(inputs[4]);
+    val.sustain = get_scalar<double>(inputs[5]);
+    val.idleTimeout = get_scalar<double>(inputs[6]);
+    pool->set_autoscaling(val);
+}
+
+void MexFunction::cpuPinning(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 4)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_cpu_pinning(get_scalar<bool>(inputs[1]),
+        get_scalar<std::size_t>(inputs[2]), get_scalar<bool>(inputs[3]));
+}
+
+void MexFunction::recycling(ArgumentList &outputs, ArgumentList &inputs)
+{
+    using namespace MatlabPool;
+
+    if (!pool)
+        throw EmptyPool();
+    if (inputs.size() != 3)
+        throw InvalidInputSize(inputs.size());
+
+    pool->set_recycling(get_scalar<std::size_t>(inputs[1]),
+        get_scalar<std::size_t>(inputs[2]));
+}
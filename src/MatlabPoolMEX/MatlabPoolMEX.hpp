@@ -5,6 +5,7 @@
 #include "mexAdapter.hpp"
 
 #include <exception>
+#include <map>
 
 #include "MatlabPool.hpp"
 
@@ -58,8 +59,59 @@ public:
     void cancel(ArgumentList &outputs, ArgumentList &inputs);
     void size(ArgumentList &outputs, ArgumentList &inputs);
     void clear(ArgumentList &outputs, ArgumentList &inputs);
+    void createSink(ArgumentList &outputs, ArgumentList &inputs);
+    void submitSink(ArgumentList &outputs, ArgumentList &inputs);
+    void waitSink(ArgumentList &outputs, ArgumentList &inputs);
+    void createGather(ArgumentList &outputs, ArgumentList &inputs);
+    void submitGather(ArgumentList &outputs, ArgumentList &inputs);
+    void waitGather(ArgumentList &outputs, ArgumentList &inputs);
+    void argumentCache(ArgumentList &outputs, ArgumentList &inputs);
+    void statusPool(ArgumentList &outputs, ArgumentList &inputs);
+    void memoize(ArgumentList &outputs, ArgumentList &inputs);
+    void invalidateMemo(ArgumentList &outputs, ArgumentList &inputs);
+    void coalesce(ArgumentList &outputs, ArgumentList &inputs);
+    void batching(ArgumentList &outputs, ArgumentList &inputs);
+    void registerTemplate(ArgumentList &outputs, ArgumentList &inputs);
+    void submitTemplate(ArgumentList &outputs, ArgumentList &inputs);
+    void unregisterTemplate(ArgumentList &outputs, ArgumentList &inputs);
+    void submitQuiet(ArgumentList &outputs, ArgumentList &inputs);
+    void outputLimit(ArgumentList &outputs, ArgumentList &inputs);
+    void readOutput(ArgumentList &outputs, ArgumentList &inputs);
+    void broadcast(ArgumentList &outputs, ArgumentList &inputs);
+    void waitBroadcast(ArgumentList &outputs, ArgumentList &inputs);
+    void initEval(ArgumentList &outputs, ArgumentList &inputs);
+    void initFeval(ArgumentList &outputs, ArgumentList &inputs);
+    void clearInit(ArgumentList &outputs, ArgumentList &inputs);
+    void submitAfter(ArgumentList &outputs, ArgumentList &inputs);
+    void submitResident(ArgumentList &outputs, ArgumentList &inputs);
+    void fetchResult(ArgumentList &outputs, ArgumentList &inputs);
+    void freeResult(ArgumentList &outputs, ArgumentList &inputs);
+    void createActor(ArgumentList &outputs, ArgumentList &inputs);
+    void callActor(ArgumentList &outputs, ArgumentList &inputs);
+    void fetchActor(ArgumentList &outputs, ArgumentList &inputs);
+    void destroyActor(ArgumentList &outputs, ArgumentList &inputs);
+    void mapReduce(ArgumentList &outputs, ArgumentList &inputs);
+    void distribute(ArgumentList &outputs, ArgumentList &inputs);
+    void spmd(ArgumentList &outputs, ArgumentList &inputs);
+    void spmdReduce(ArgumentList &outputs, ArgumentList &inputs);
+    void freeDistributed(ArgumentList &outputs, ArgumentList &inputs);
+    void scheduler(ArgumentList &outputs, ArgumentList &inputs);
+    void speculation(ArgumentList &outputs, ArgumentList &inputs);
+    void submitCost(ArgumentList &outputs, ArgumentList &inputs);
+    void addLane(ArgumentList &outputs, ArgumentList &inputs);
+    void submitLane(ArgumentList &outputs, ArgumentList &inputs);
+    void statusLanes(ArgumentList &outputs, ArgumentList &inputs);
+    void onPool(ArgumentList &outputs, ArgumentList &inputs);
+    void closePool(ArgumentList &outputs, ArgumentList &inputs);
+    void autoscale(ArgumentList &outputs, ArgumentList &inputs);
+    void cpuPinning(ArgumentList &outputs, ArgumentList &inputs);
+    void recycling(ArgumentList &outputs, ArgumentList &inputs);
 
 private:
+    // the following commands use the named pool, a missing pool is
+    // created by "resize"
+    void select_pool(std::u16string name);
+
     template <typename T>
     inline T get_scalar(const matlab::data::Array &data) const
     {
@@ -69,6 +121,13 @@ private:
         return val;
     }
 
+    template <typename T>
+    inline std::vector<T> get_vector(const matlab::data::Array &data) const
+    {
+        matlab::data::TypedArray<T> tmp = data;
+        return std::vector<T>(tmp.begin(), tmp.end());
+    }
+
     template <typename T>
     inline void throwError(const char *id, const T &msg)
     {
@@ -82,7 +141,13 @@ private:
 private:
     matlab::data::ArrayFactory factory;
     MatlabPtr matlabPtr = getEngine();
-    std::unique_ptr<MatlabPool::Pool> pool;
+
+    // named pools, each with its own engine options, the default
+    // pool has an empty name. "pool" is the pool of the current 
+    // command (see "onPool")
+    std::map<std::u16string, std::unique_ptr<MatlabPool::Pool>> pools;
+    std::u16string poolName;
+    MatlabPool::Pool *pool = nullptr;
 };
 
 #endif
\ No newline at end of file
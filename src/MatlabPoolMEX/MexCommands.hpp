@@ -38,6 +38,53 @@ namespace MatlabPool
             /*  6 */{ "cancel", &MexFunction::cancel },
             /*  7 */{ "size", &MexFunction::size },
             /*  8 */{ "clear", &MexFunction::clear },
+            /*  9 */{ "createSink", &MexFunction::createSink },
+            /* 10 */{ "submitSink", &MexFunction::submitSink },
+            /* 11 */{ "waitSink", &MexFunction::waitSink },
+            /* 12 */{ "createGather", &MexFunction::createGather },
+            /* 13 */{ "submitGather", &MexFunction::submitGather },
+            /* 14 */{ "waitGather", &MexFunction::waitGather },
+            /* 15 */{ "argumentCache", &MexFunction::argumentCache },
+            /* 16 */{ "statusPool", &MexFunction::statusPool },
+            /* 17 */{ "memoize", &MexFunction::memoize },
+            /* 18 */{ "invalidateMemo", &MexFunction::invalidateMemo },
+            /* 19 */{ "coalesce", &MexFunction::coalesce },
+            /* 20 */{ "batching", &MexFunction::batching },
+            /* 21 */{ "registerTemplate", &MexFunction::registerTemplate },
+            /* 22 */{ "submitTemplate", &MexFunction::submitTemplate },
+            /* 23 */{ "unregisterTemplate", &MexFunction::unregisterTemplate },
+            /* 24 */{ "submitQuiet", &MexFunction::submitQuiet },
+            /* 25 */{ "outputLimit", &MexFunction::outputLimit },
+            /* 26 */{ "readOutput", &MexFunction::readOutput },
+            /* 27 */{ "broadcast", &MexFunction::broadcast },
+            /* 28 */{ "waitBroadcast", &MexFunction::waitBroadcast },
+            /* 29 */{ "initEval", &MexFunction::initEval },
+            /* 30 */{ "initFeval", &MexFunction::initFeval },
+            /* 31 */{ "clearInit", &MexFunction::clearInit },
+            /* 32 */{ "submitAfter", &MexFunction::submitAfter },
+            /* 33 */{ "submitResident", &MexFunction::submitResident },
+            /* 34 */{ "fetchResult", &MexFunction::fetchResult },
+            /* 35 */{ "freeResult", &MexFunction::freeResult },
+            /* 36 */{ "createActor", &MexFunction::createActor },
+            /* 37 */{ "callActor", &MexFunction::callActor },
+            /* 38 */{ "fetchActor", &MexFunction::fetchActor },
+            /* 39 */{ "destroyActor", &MexFunction::destroyActor },
+            /* 40 */{ "mapReduce", &MexFunction::mapReduce },
+            /* 41 */{ "distribute", &MexFunction::distribute },
+            /* 42 */{ "spmd", &MexFunction::spmd },
+            /* 43 */{ "spmdReduce", &MexFunction::spmdReduce },
+            /* 44 */{ "freeDistributed", &MexFunction::freeDistributed },
+            /* 45 */{ "scheduler", &MexFunction::scheduler },
+            /* 46 */{ "speculation", &MexFunction::speculation },
+            /* 47 */{ "submitCost", &MexFunction::submitCost },
+            /* 48 */{ "addLane", &MexFunction::addLane },
+            /* 49 */{ "submitLane", &MexFunction::submitLane },
+            /* 50 */{ "statusLanes", &MexFunction::statusLanes },
+            /* 51 */{ "onPool", &MexFunction::onPool },
+            /* 52 */{ "closePool", &MexFunction::closePool },
+            /* 53 */{ "autoscale", &MexFunction::autoscale },
+            /* 54 */{ "cpuPinning", &MexFunction::cpuPinning },
+            /* 55 */{ "recycling", &MexFunction::recycling },
         };
 
         inline static constexpr CmdID nof_commands = CmdID(sizeof(commands) / sizeof(Cmd));
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <chrono>
+
+#include "MatlabPool.hpp"
+
+// Throughput of the central queue, the work-stealing scheduler and the
+// longest-job-first scheduler (with the durations as cost hints) for
+// jobs with skewed durations: most jobs are short, a few are long.
+// Usage: matlabpool_bench [nof_worker] [nof_jobs]
+
+namespace
+{
+    using namespace MatlabPool;
+
+    // durations in seconds, Pareto distributed (shape 1.5)
+    std::vector<double> make_durations(std::size_t n)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<double> result(n);
+        for (auto &e : result)
+            e = std::min(0.001 / std::pow(1.0 - uniform(gen), 1.0 / 1.5), 1.0);
+        return result;
+    }
+
+    double run(Pool &pool, const std::vector<double> &durations, bool hints = false)
+    {
+        matlab::data::ArrayFactory factory;
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<JobID> jobid;
+        jobid.reserve(durations.size());
+        for (double t : durations)
+        {
+            JobFeval job(u"pause", 0, {factory.createScalar<double>(t)});
+            if (hints)
+                job.set_cost(t);
+            jobid.push_back(pool.submit(std::move(job)));
+        }
+        for (JobID id : jobid)
+            pool.wait(id);
+
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        return double(durations.size()) / time.count();
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    unsigned int nof_worker = argc > 1 ? unsigned(std::stoul(argv[1])) : 4;
+    std::size_t nof_jobs = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+    std::vector<std::u16string> options = {u"-nojvm", u"-nosplash"};
+    auto pool = std::unique_ptr<Pool>(PoolLibLoader::createPool(nof_worker, options));
+    auto durations = make_durations(nof_jobs);
+
+    double sum = 0;
+    for (double t : durations)
+        sum += t;
+    std::cout << nof_worker << " workers, " << nof_jobs << " jobs, "
+              << "ideal " << std::fixed << std::setprecision(1)
+              << double(nof_jobs) * nof_worker / sum << " jobs/s\n";
+
+    // warm-up of the workers
+    run(*pool, make_durations(nof_worker * 10));
+
+    const std::pair<Pool::Scheduler, const char *> types[] = {
+        {Pool::Scheduler::Central, "central"},
+        {Pool::Scheduler::WorkStealing, "work stealing"},
+        {Pool::Scheduler::LongestFirst, "longest first"}};
+    for (const auto &type : types)
+    {
+        pool->set_scheduler(type.first);
+        double throughput = run(*pool, durations,
+            type.first == Pool::Scheduler::LongestFirst);
+        std::cout << std::setw(14) << std::left << type.second
+                  << std::right << std::setw(10) << throughput << " jobs/s\n";
+    }
+    return 0;
+}
@@ -2,13 +2,41 @@
 #include <exception>
 
 #include "MatlabPool.hpp"
+#include "MatlabEngine.hpp"
 #include "TestSuite.hpp"
 
 #include <queue>
+#include <set>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <new>
 #include <thread>
 
+// every heap allocation of the process (including the pool library
+// and the MATLAB Engine API) is counted by the replaced "operator new"
+static std::atomic<std::uint64_t> allocations{ 0 };
+static thread_local std::uint64_t thread_allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    ++thread_allocations;
+    if (void *ptr = std::malloc(size > 0 ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 // TODO test mit valgrind
 // TODO test C0 ueberdeckung
 
@@ -273,6 +301,908 @@ std::size_t run_tests()
             UnexpectCondition("unexpect jobs in pool");
     });
 
+    test.run("shared memory output sink", Effort::Normal, [&]() {
+        using Float = double;
+        constexpr std::size_t rows = 4;
+        constexpr std::size_t cols = 6;
+
+        SinkID sink = pool->create_sink(matlab::data::ArrayType::DOUBLE,
+                                        {rows, cols});
+        for (std::size_t i = 0; i < rows / 2; i++)
+            for (std::size_t j = 0; j < cols / 2; j++)
+            {
+                pool->submit(
+                    JobFeval(u"repmat", 0, {factory.createScalar<Float>(Float(i + 10 * j)),
+                                            factory.createScalar<Float>(2),
+                                            factory.createScalar<Float>(2)}),
+                    sink, {{2 * i, 2 * j}, {2, 2}});
+            }
+
+        matlab::data::TypedArray<Float> result = pool->wait_sink(sink);
+        Assert(rows * cols == result.getNumberOfElements(), "unexpect size of result");
+        for (std::size_t i = 0; i < rows; i++)
+            for (std::size_t j = 0; j < cols; j++)
+                Assert(Float(i / 2 + 10 * (j / 2)) == Float(result[i][j]),
+                       "unexpect result");
+    });
+
+    test.run("invalid slice for output sink", Effort::Small, [&]() {
+        SinkID sink = pool->create_sink(matlab::data::ArrayType::UINT8, {2, 2});
+        UnexpectException<Pool::InvalidSlice>::check([&]() {
+            pool->submit(JobFeval(u"zeros", 0, {factory.createScalar<double>(2)}),
+                         sink, {{1, 1}, {2, 2}});
+        });
+        pool->wait_sink(sink);
+    });
+
+    test.run("gather results in place", Effort::Normal, [&]() {
+        using Float = double;
+        constexpr std::size_t rows = 4;
+        constexpr std::size_t cols = 6;
+
+        std::vector<Utilities::Slice> slices;
+        for (std::size_t i = 0; i < rows / 2; i++)
+            for (std::size_t j = 0; j < cols / 2; j++)
+                slices.push_back({{2 * i, 2 * j}, {2, 2}});
+
+        GatherID gather = pool->create_gather(
+            factory.createArray<Float>({rows, cols}), slices);
+        for (std::size_t i = 0; i < slices.size(); i++)
+        {
+            Float val = Float(slices[i].offset[0] / 2 + 10 * (slices[i].offset[1] / 2));
+            pool->submit(
+                JobFeval(u"repmat", 1, {factory.createScalar<Float>(val),
+                                        factory.createScalar<Float>(2),
+                                        factory.createScalar<Float>(2)}),
+                gather, i);
+        }
+
+        matlab::data::TypedArray<Float> result = pool->wait_gather(gather);
+        for (std::size_t i = 0; i < rows; i++)
+            for (std::size_t j = 0; j < cols; j++)
+                Assert(Float(i / 2 + 10 * (j / 2)) == Float(result[i][j]),
+                       "unexpect result");
+    });
+
+    test.run("gather with invalid job", Effort::Normal, [&]() {
+        GatherID gather = pool->create_gather(
+            factory.createArray<double>({2, 2}), {{{0, 0}, {2, 2}}});
+        pool->submit(JobFeval(u"sqqqqrt", 1, {factory.createScalar<double>(1)}),
+                     gather, 0);
+        UnexpectException<JobBase::ExecutionError>::check([&]() {
+            pool->wait_gather(gather);
+        });
+    });
+
+    test.run("argument cache", Effort::Normal, [&]() {
+        using Float = double;
+        constexpr std::size_t n = 1000;
+        constexpr std::size_t n_arrays = 3;
+
+        // only two arrays fit into the cache of a worker
+        pool->set_argument_cache(1024, 2 * n * sizeof(Float) + 1024);
+
+        std::vector<matlab::data::TypedArray<Float>> data;
+        for (std::size_t k = 0; k < n_arrays; k++)
+        {
+            data.push_back(factory.createArray<Float>({1, n}));
+            for (std::size_t i = 0; i < n; i++)
+                data.back()[i] = Float(k + 1);
+        }
+
+        std::vector<JobID> jobid;
+        for (std::size_t i = 0; i < 10 * n_arrays; i++)
+            jobid.push_back(pool->submit(JobFeval(u"sum", 1, {data[i % n_arrays]})));
+
+        for (std::size_t i = 0; i < jobid.size(); i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(n * (i % n_arrays + 1)) == result[0], "unexpect result");
+        }
+
+        // the workers lose their cached arguments, the jobs are sent 
+        // again with all arguments
+        pool->wait_broadcast(pool->broadcast(u"evalin", 0,
+            {factory.createCharArray("base"), factory.createCharArray("clear functions")}));
+        jobid.clear();
+        for (std::size_t i = 0; i < 10 * n_arrays; i++)
+            jobid.push_back(pool->submit(JobFeval(u"sum", 1, {data[i % n_arrays]})));
+        for (std::size_t i = 0; i < jobid.size(); i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            Assert(job.get_status() == JobFeval::Status::Done, "unexpect cache miss");
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(n * (i % n_arrays + 1)) == result[0], "unexpect result");
+        }
+
+        // the first array is stored, evicted and stored again by a 
+        // single job, the workers must keep it
+        jobid.clear();
+        for (std::size_t i = 0; i < pool->size(); i++)
+            jobid.push_back(pool->submit(JobFeval(u"horzcat", 1, {data[0], data[1], data[2], data[0]})));
+        for (auto id : jobid)
+            Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+        jobid.clear();
+        for (std::size_t i = 0; i < 10 * pool->size(); i++)
+            jobid.push_back(pool->submit(JobFeval(u"sum", 1, {data[0]})));
+        for (auto id : jobid)
+        {
+            JobFeval job = pool->wait(id);
+            Assert(job.get_status() == JobFeval::Status::Done, "unexpect cache miss");
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(n) == result[0], "unexpect result");
+        }
+
+        pool->set_argument_cache(1 << 20, 256 << 20);
+    });
+
+    test.run("memoization", Effort::Normal, [&]() {
+        using Float = double;
+        auto run = [&]() {
+            JobID id = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<Float>(16)}));
+            JobFeval job = pool->wait(id);
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(4) == result[0], "unexpect result");
+        };
+        auto get_counter = [&](const char *name) {
+            matlab::data::TypedArray<std::uint64_t> val = pool->get_pool_status()[0][name];
+            return std::uint64_t(val[0]);
+        };
+
+        pool->set_memoization(1 << 20, u"");
+        std::uint64_t hits = get_counter("MemoHits");
+        std::uint64_t misses = get_counter("MemoMisses");
+
+        run();
+        run();
+        Assert(get_counter("MemoHits") == hits + 1, "expect a hit");
+        Assert(get_counter("MemoMisses") == misses + 1, "expect a miss");
+
+        pool->invalidate_memoization(u"sqrt");
+        run();
+        Assert(get_counter("MemoMisses") == misses + 2, "expect a miss");
+
+        pool->set_memoization(0, u"");
+        pool->invalidate_memoization(u"");
+    });
+
+    test.run("coalesce identical jobs", Effort::Normal, [&]() {
+        using Float = double;
+        pool->set_coalescing(true);
+
+        // keep all workers busy, so that the identical jobs are queued
+        std::vector<JobID> busy;
+        for (std::size_t i = 0; i < pool->size(); i++)
+            busy.push_back(pool->submit(
+                JobFeval(u"pause", 0, {factory.createScalar<Float>(0.5)})));
+
+        std::array<JobID, 3> jobid;
+        for (auto &id : jobid)
+            id = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<Float>(16)}));
+
+        // canceling the first job must not cancel the others
+        pool->cancel(jobid[0]);
+        for (std::size_t i = 1; i < jobid.size(); i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(4) == result[0], "unexpect result");
+        }
+
+        for (auto id : busy)
+            pool->wait(id);
+        pool->set_coalescing(false);
+    });
+
+    test.run("batching of small jobs", Effort::Normal, [&]() {
+        using Float = double;
+        pool->set_batching(16, 0.05);
+
+        std::array<JobID, N> jobid;
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<Float>(Float(i))}));
+        JobID invalid = pool->submit(JobFeval(u"sqrt", 1, {factory.createCellArray({1, 1})}));
+
+        for (std::size_t i = 0; i < N; i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(std::sqrt(Float(i)) == Float(result[0]), "unexpect result");
+        }
+
+        // the error of a single job does not affect the other jobs
+        JobFeval job = pool->wait(invalid);
+        UnexpectException<JobBase::ExecutionError>::check([&]() {
+            job.pop_result();
+        });
+
+        // functions without return values
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(JobFeval(u"assert", 0, {factory.createScalar<bool>(true)}));
+        for (std::size_t i = 0; i < N; i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            Assert(job.pop_result().empty(), "unexpect result");
+        }
+
+        pool->set_batching(0, 0);
+    });
+
+    test.run("job templates", Effort::Normal, [&]() {
+        using Float = double;
+        TemplateID tmpl = pool->register_template(u"plus", 1, {factory.createScalar<Float>(10)});
+
+        std::array<JobID, N> jobid;
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(tmpl, {factory.createScalar<Float>(Float(i))});
+
+        for (std::size_t i = 0; i < N; i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(i + 10) == result[0], "unexpect result");
+        }
+
+        pool->unregister_template(tmpl);
+        UnexpectException<Pool::TemplateNotExists>::check([&]() {
+            pool->submit(tmpl, {factory.createScalar<Float>(1)});
+        });
+    });
+
+    test.run("unregister a template with queued jobs", Effort::Normal, [&]() {
+        using Float = double;
+        TemplateID tmpl = pool->register_template(u"plus", 1, {factory.createScalar<Float>(10)});
+
+        std::vector<JobID> jobid(4 * N);
+        for (std::size_t i = 0; i < jobid.size(); i++)
+            jobid[i] = pool->submit(tmpl, {factory.createScalar<Float>(Float(i))});
+        pool->unregister_template(tmpl);
+
+        for (std::size_t i = 0; i < jobid.size(); i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(i + 10) == result[0], "unexpect result");
+        }
+    });
+
+    test.run("output capture", Effort::Normal, [&]() {
+        constexpr std::size_t limit = 100;
+        pool->set_output_limit(limit);
+
+        JobFeval job1(u"disp", 0, {factory.createCharArray(std::string(2 * limit, 'x'))});
+        job1 = pool->wait(pool->submit(std::move(job1)));
+        Assert(job1.get_outBuf().truncated(), "output should be truncated");
+
+        JobFeval job2(u"disp", 0, {factory.createCharArray("Hello World")});
+        job2.set_capture(false, true);
+        job2 = pool->wait(pool->submit(std::move(job2)));
+        Assert(job2.get_outBuf().empty(), "output buffer should be empty");
+
+        pool->set_output_limit(StreamBuf::default_limit);
+    });
+
+    test.run("read output of a running job", Effort::Normal, [&]() {
+        JobID id = pool->submit(JobFeval(u"eval", 0,
+            {factory.createCharArray("disp('Hello World'); pause(2)")}));
+
+        std::u16string output;
+        for (int i = 0; i < 100 && output.empty(); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            output = pool->read_output(id, false);
+        }
+        Assert(!output.empty(), "no output of the running job");
+        Assert(pool->read_output(id, false).empty(), "output should be read once");
+
+        pool->cancel(id);
+    });
+
+    test.run("broadcast", Effort::Normal, [&]() {
+        using Float = double;
+        std::vector<JobID> jobid(N);
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<Float>(Float(i))}));
+
+        BroadcastID id = pool->broadcast(u"feature", 1, {factory.createCharArray("getpid")});
+        std::vector<JobFeval> jobs = pool->wait_broadcast(id);
+        Assert(jobs.size() == pool->size(), "one job for each worker");
+
+        std::set<int> workers;
+        for (auto &job : jobs)
+        {
+            Assert(job.get_status() == JobFeval::Status::Done, "unexpect status");
+            workers.insert(job.get_workerID());
+        }
+        Assert(workers.size() == pool->size(), "every worker should evaluate the job");
+
+        for (auto e : jobid)
+            pool->wait(e);
+    });
+
+    test.run("initialization profile", Effort::Large, [&]() {
+        using Float = double;
+        pool->wait_broadcast(pool->add_init_eval(u"matlabpool_init = 42;"));
+
+        // a failing step is not added to the profile
+        for (auto &job : pool->wait_broadcast(pool->add_init_eval(u"error('init failed')")))
+            Assert(job.get_status() == JobFeval::Status::Error, "expect a failed job");
+
+        // the new worker evaluates the profile
+        std::size_t n = pool->size();
+        pool->resize(n + 1, options);
+        Assert(pool->size() == n + 1, "expect a new worker");
+
+        BroadcastID id = pool->broadcast(u"evalin", 1,
+            {factory.createCharArray("base"), factory.createCharArray("matlabpool_init")});
+        for (auto &job : pool->wait_broadcast(id))
+        {
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(Float(42) == result[0], "unexpect result");
+        }
+
+        pool->resize(n, options);
+        pool->clear_init();
+        pool->wait_broadcast(pool->broadcast(u"evalin", 0,
+            {factory.createCharArray("base"), factory.createCharArray("clear matlabpool_init")}));
+    });
+
+    test.run("job graph", Effort::Normal, [&]() {
+        using Float = double;
+        auto placeholder = [&]() { return factory.createArray<Float>({ 0, 0 }); };
+
+        JobID id1 = pool->submit(JobFeval(u"magic", 1, {factory.createScalar<Float>(4)}));
+        JobID id2 = pool->submit(JobFeval(u"sum", 1, {placeholder()}), {{id1, 0, 0}});
+        JobID id3 = pool->submit(JobFeval(u"sum", 1, {placeholder()}), {{id2, 0, 0}});
+
+        JobFeval job = pool->wait(id3);
+        matlab::data::TypedArray<Float> result = job.peek_result()[0];
+        Assert(Float(136) == result[0], "unexpect result");
+
+        // the failure is propagated along the graph
+        JobID id4 = pool->submit(JobFeval(u"error", 0, {factory.createCharArray("failed")}));
+        JobID id5 = pool->submit(JobFeval(u"sum", 1, {placeholder()}), {{id4, 0, 0}});
+        JobID id6 = pool->submit(JobFeval(u"disp", 0, {factory.createCharArray("x")}),
+            {{id5, JobDependency::none, JobDependency::none}});
+        Assert(pool->wait(id6).get_status() == JobFeval::Status::Error, "expect an error");
+
+        for (JobID id : {id1, id2, id4, id5})
+            pool->wait(id);
+    });
+
+    test.run("worker-resident results", Effort::Normal, [&]() {
+        using Float = double;
+
+        JobID ref = pool->submit_resident(JobFeval(u"magic", 1, {factory.createScalar<Float>(4)}));
+        JobID id = pool->submit(JobFeval(u"sum", 1, {factory.createArray<Float>({ 0, 0 })}),
+            {{ref, 0, 0}});
+        matlab::data::TypedArray<Float> sum = pool->wait(id).peek_result()[0];
+        Assert(Float(34) == sum[0], "unexpect result");
+
+        // the job returns only the metadata
+        matlab::data::StructArray info = pool->wait(ref).peek_result()[0];
+        matlab::data::TypedArray<double> bytes = info[0]["bytes"];
+        Assert(bytes[0] == 16 * sizeof(Float), "unexpect metadata");
+
+        matlab::data::TypedArray<Float> value = pool->fetch_result(ref).at(0);
+        Assert(value.getNumberOfElements() == 16, "unexpect result");
+        pool->free_result(ref);
+        UnexpectException<Pool::ResultNotExists>::check([&]() {
+            pool->fetch_result(ref);
+        });
+    });
+
+    test.run("work stealing", Effort::Normal, [&]() {
+        using Float = double;
+        pool->set_scheduler(Pool::Scheduler::WorkStealing);
+
+        std::vector<JobID> jobid(N);
+        std::vector<bool> worker_used(pool->size(), false);
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<Float>(Float(i))}));
+        for (std::size_t i = 0; i < N; i++)
+        {
+            JobFeval job = pool->wait(jobid[i]);
+            worker_used[job.get_workerID()] = true;
+            matlab::data::TypedArray<Float> result = job.peek_result()[0];
+            Assert(std::sqrt(Float(i)) == Float(result[0]), "unexpect result");
+        }
+        pool->set_scheduler(Pool::Scheduler::Central);
+        Assert(std::all_of(worker_used.begin(), worker_used.end(), [](bool b) { return b; }),
+            "not all workers are used");
+    });
+
+    test.run("longest job first", Effort::Normal, [&]() {
+        using Float = double;
+        pool->set_scheduler(Pool::Scheduler::LongestFirst);
+
+        // the workers are busy, so the jobs wait in the queue
+        std::vector<JobID> blocker(pool->size());
+        for (auto &id : blocker)
+            id = pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(0.5)}));
+
+        std::vector<JobID> jobid(N);
+        for (std::size_t i = 0; i < N; i++)
+        {
+            JobFeval job(u"sqrt", 1, {factory.createScalar<Float>(Float(i))});
+            job.set_cost(Float(i + 1));
+            jobid[i] = pool->submit(std::move(job));
+        }
+
+        // queued jobs in the order of their cost hints
+        auto status = pool->get_job_status();
+        matlab::data::TypedArray<JobID> queued = status[0]["JobID"];
+        matlab::data::TypedArray<std::uint8_t> state = status[0]["Status"];
+        JobID last = 0;
+        for (std::size_t i = 0; i < queued.getNumberOfElements(); i++)
+        {
+            if (state[i] != static_cast<std::uint8_t>(JobFeval::Status::Wait) ||
+                std::find(jobid.begin(), jobid.end(), queued[i]) == jobid.end())
+                continue;
+            Assert(last == 0 || queued[i] < last, "unexpect order of the jobs");
+            last = queued[i];
+        }
+
+        for (std::size_t i = 0; i < N; i++)
+        {
+            matlab::data::TypedArray<Float> result = pool->wait(jobid[i]).peek_result()[0];
+            Assert(std::sqrt(Float(i)) == Float(result[0]), "unexpect result");
+        }
+        for (JobID id : blocker)
+            pool->wait(id);
+        pool->set_scheduler(Pool::Scheduler::Central);
+    });
+
+    test.run("latency lanes", Effort::Normal, [&]() {
+        using Float = double;
+        LaneID lane = pool->add_lane(u"interactive", 1, 0.5);
+        Assert(lane == pool->add_lane(u"interactive", 1, 0.5), "expect the same lane");
+        UnexpectException<Pool::LaneNotExists>::check([&]() {
+            JobFeval job(u"sqrt", 1, {factory.createScalar<Float>(1)});
+            job.set_lane(lane + 100);
+            pool->submit(std::move(job));
+        });
+
+        // a long batch in the default lane
+        std::vector<JobID> batch(2 * pool->size());
+        for (auto &id : batch)
+            id = pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(0.5)}));
+
+        std::vector<JobID> jobid(N);
+        for (std::size_t i = 0; i < N; i++)
+        {
+            JobFeval job(u"sqrt", 1, {factory.createScalar<Float>(Float(i))});
+            job.set_lane(lane);
+            jobid[i] = pool->submit(std::move(job));
+        }
+        for (std::size_t i = 0; i < N; i++)
+        {
+            matlab::data::TypedArray<Float> result = pool->wait(jobid[i]).peek_result()[0];
+            Assert(std::sqrt(Float(i)) == Float(result[0]), "unexpect result");
+        }
+
+        matlab::data::StructArray status = pool->get_lane_status();
+        matlab::data::TypedArray<std::uint64_t> started = status[0]["Started"];
+        Assert(started.getNumberOfElements() >= 2 && started[lane] >= N, "unexpect lane status");
+
+        for (JobID id : batch)
+            pool->wait(id);
+    });
+
+    test.run("lane counters after short jobs", Effort::Normal, [&]() {
+        using Float = double;
+        // the workers are reused immediately by the master
+        std::vector<JobID> jobid(10 * N);
+        for (std::size_t i = 0; i < jobid.size(); i++)
+            jobid[i] = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<Float>(Float(i))}));
+        for (JobID id : jobid)
+            Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+
+        // the notifier may still run after "wait"
+        bool idle = false;
+        for (std::size_t k = 0; k < 100 && !idle; k++)
+        {
+            matlab::data::StructArray status = pool->get_lane_status();
+            matlab::data::TypedArray<std::uint64_t> running = status[0]["Running"];
+            idle = true;
+            for (auto n : running)
+                idle = idle && n == 0;
+            if (!idle)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        Assert(idle, "expect no running jobs in the lanes");
+    });
+
+    test.run("speculative re-execution", Effort::Large, [&]() {
+        using Float = double;
+        pool->set_speculation(2);
+
+        // runtime history of the function
+        std::vector<JobID> jobid(N);
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(0.05)}));
+        for (std::size_t i = 0; i < N; i++)
+            pool->wait(jobid[i]);
+
+        matlab::data::StructArray before = pool->get_pool_status();
+        JobID id = pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(1)}));
+        Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+        matlab::data::StructArray after = pool->get_pool_status();
+        pool->set_speculation(0);
+
+        matlab::data::TypedArray<std::uint64_t> copies0 = before[0]["SpeculativeCopies"];
+        matlab::data::TypedArray<std::uint64_t> copies1 = after[0]["SpeculativeCopies"];
+        Assert(pool->size() < 2 || copies1[0] > copies0[0], "expect a speculative copy");
+    });
+
+    test.run("autoscaling", Effort::Huge, [&]() {
+        auto wait_size = [&](std::size_t n) {
+            for (std::size_t i = 0; i < 600 && pool->size() != n; i++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return pool->size() == n;
+        };
+
+        std::size_t n = pool->size();
+        Pool::Autoscaling val;
+        val.minSize = n + 1;
+        val.maxSize = n + 1;
+        pool->set_autoscaling(val);
+        Assert(wait_size(n + 1), "expect a new worker");
+
+        JobID id = pool->submit(JobFeval(u"sqrt", 1, {factory.createScalar<double>(4)}));
+        Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+
+        val.minSize = n;
+        val.maxSize = n;
+        pool->set_autoscaling(val);
+        Assert(wait_size(n), "expect the previous size");
+        pool->set_autoscaling(Pool::Autoscaling());
+
+        matlab::data::StructArray status = pool->get_pool_status();
+        matlab::data::TypedArray<std::uint64_t> ups = status[0]["ScaleUps"];
+        matlab::data::TypedArray<std::uint64_t> downs = status[0]["ScaleDowns"];
+        Assert(ups[0] > 0 && downs[0] > 0, "unexpect pool status");
+    });
+
+    test.run("autoscaling triggers", Effort::Huge, [&]() {
+        using Float = double;
+        auto wait_size = [&](std::size_t n) {
+            for (std::size_t i = 0; i < 600 && pool->size() != n; i++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return pool->size() == n;
+        };
+        auto get_ups = [&]() {
+            matlab::data::TypedArray<std::uint64_t> val = pool->get_pool_status()[0]["ScaleUps"];
+            return std::uint64_t(val[0]);
+        };
+        // "k" jobs per worker, the last ones wait in the queue
+        auto burst = [&](std::size_t k, Float pause) {
+            std::vector<JobID> jobid;
+            for (std::size_t i = 0; i < k * pool->size(); i++)
+                jobid.push_back(pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(pause)})));
+            return jobid;
+        };
+        auto wait_all = [&](const std::vector<JobID> &jobid) {
+            for (auto id : jobid)
+                Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+        };
+
+        std::size_t n = pool->size();
+        Pool::Autoscaling val;
+        val.minSize = n;
+        val.maxSize = n + 1;
+        val.queueDepth = 1;
+        val.queueWait = 1e6;
+        val.sustain = 2.5;
+        val.idleTimeout = 1e6;
+        pool->set_autoscaling(val);
+
+        // two short overloads, the overload period starts again after
+        // the queue is drained
+        std::uint64_t ups = get_ups();
+        for (std::size_t k = 0; k < 2; k++)
+        {
+            wait_all(burst(5, 0.5));
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+        Assert(get_ups() == ups && pool->size() == n, "unexpect growth without sustained overload");
+
+        // queue depth: more than one queued job per worker
+        val.sustain = 0.5;
+        pool->set_autoscaling(val);
+        auto jobid = burst(6, 1.0);
+        Assert(wait_size(n + 1), "expect a new worker for the queue depth");
+        wait_all(jobid);
+
+        // idle timeout, but not while the last worker holds a block
+        val.idleTimeout = 1;
+        pool->set_autoscaling(val);
+        DistributedID d = pool->distribute(factory.createArray<Float>({1, 4 * (n + 1)}), 1);
+        std::this_thread::sleep_for(std::chrono::seconds(4));
+        Assert(pool->size() == n + 1, "the worker of a block was removed");
+        pool->free_distributed(d);
+        Assert(wait_size(n), "expect a removed worker after the idle timeout");
+
+        // queue wait: the oldest job waits too long
+        val.queueDepth = 1000;
+        val.queueWait = 0.5;
+        val.idleTimeout = 1e6;
+        pool->set_autoscaling(val);
+        jobid = burst(3, 2.0);
+        Assert(wait_size(n + 1), "expect a new worker for the queue wait");
+        wait_all(jobid);
+
+        pool->set_autoscaling(Pool::Autoscaling());
+        pool->resize(n, options);
+    });
+
+    test.run("cpu pinning", Effort::Large, [&]() {
+        auto check_layout = [&]() {
+            matlab::data::StructArray status = pool->get_worker_status();
+            matlab::data::TypedArray<std::uint64_t> pid = status[0]["Pid"];
+            matlab::data::CellArray cpus = status[0]["Cpus"];
+            Assert(pid.getNumberOfElements() == pool->size() &&
+                cpus.getNumberOfElements() == pool->size(), "unexpect worker status");
+
+            // the sets are always disjoint, the workers without a set 
+            // are not pinned
+            std::set<std::uint32_t> used;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < pool->size(); i++)
+            {
+                Assert(pid[i] > 0, "unexpect process id");
+                matlab::data::TypedArray<std::uint32_t> set = cpus[i];
+                for (auto cpu : set)
+                    used.insert(cpu);
+                count += set.getNumberOfElements();
+            }
+            Assert(used.size() == count, "expect disjoint cpu sets");
+        };
+
+        pool->set_cpu_pinning(true, 0, false);
+        check_layout();
+
+        // the added workers get their own sets
+        std::size_t n = pool->size();
+        pool->resize(n + 2, options);
+        check_layout();
+        pool->resize(n, options);
+        check_layout();
+
+        JobID id = pool->submit(JobFeval(u"maxNumCompThreads", 1, {}));
+        Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+        pool->set_cpu_pinning(false, 0, false);
+    });
+
+    test.run("engine recycling", Effort::Huge, [&]() {
+        using Float = double;
+        matlab::data::StructArray before = pool->get_worker_status();
+        matlab::data::TypedArray<std::uint64_t> pid0 = before[0]["Pid"];
+
+        pool->set_recycling(2, 0);
+        std::vector<JobID> jobid(N);
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(0.05)}));
+        for (std::size_t i = 0; i < N; i++)
+            Assert(pool->wait(jobid[i]).get_status() == JobFeval::Status::Done,
+                "expect a finished job");
+
+        // the engines are checked periodically
+        std::uint64_t recycled = 0;
+        for (std::size_t i = 0; i < 600 && recycled == 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            matlab::data::StructArray status = pool->get_pool_status();
+            matlab::data::TypedArray<std::uint64_t> tmp = status[0]["RecycledEngines"];
+            recycled = tmp[0];
+        }
+        pool->set_recycling(0, 0);
+        Assert(recycled > 0, "expect a new engine");
+
+        matlab::data::StructArray after = pool->get_worker_status();
+        matlab::data::TypedArray<std::uint64_t> pid1 = after[0]["Pid"];
+        Assert(pid1.getNumberOfElements() == pid0.getNumberOfElements(),
+            "unexpect pool size");
+        bool changed = false;
+        for (std::size_t i = 0; i < pid0.getNumberOfElements(); i++)
+            changed = changed || pid0[i] != pid1[i];
+        Assert(changed, "expect a new process");
+    });
+
+    test.run("recycling keeps actors", Effort::Huge, [&]() {
+        using Float = double;
+        auto get_recycled = [&]() {
+            matlab::data::TypedArray<std::uint64_t> tmp = pool->get_pool_status()[0]["RecycledEngines"];
+            return std::uint64_t(tmp[0]);
+        };
+
+        ActorID actor = pool->create_actor(u"struct",
+            {factory.createCharArray("n"), factory.createScalar<Float>(0)});
+        std::uint64_t recycled0 = get_recycled();
+        pool->set_recycling(1, 0);
+
+        // the other workers are replaced meanwhile
+        std::vector<JobID> jobid;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            jobid.push_back(pool->call_actor(actor, u"setfield", 0,
+                {factory.createCharArray("n"), factory.createScalar<Float>(Float(i + 1))}));
+            jobid.push_back(pool->submit(JobFeval(u"pause", 0, {factory.createScalar<Float>(0.01)})));
+        }
+        for (auto id : jobid)
+            Assert(pool->wait(id).get_status() == JobFeval::Status::Done, "expect a finished job");
+        for (std::size_t i = 0; i < 600 && get_recycled() == recycled0; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Assert(pool->size() == 1 || get_recycled() > recycled0, "expect a new engine");
+
+        matlab::data::StructArray state = pool->fetch_actor(actor);
+        matlab::data::TypedArray<Float> n = state[0]["n"];
+        pool->set_recycling(0, 0);
+        pool->destroy_actor(actor);
+        Assert(Float(N) == n[0], "the actor lost its state");
+    });
+
+    test.run("map reduce", Effort::Normal, [&]() {
+        using Float = double;
+
+        std::vector<std::vector<matlab::data::Array>> inputs(N);
+        for (std::size_t i = 0; i < N; i++)
+            inputs[i].push_back(factory.createScalar<Float>(Float(i)));
+        matlab::data::StructArray before = pool->get_pool_status();
+        JobID id = pool->map_reduce(u"sqrt", u"plus", std::move(inputs));
+
+        Float expect = 0;
+        for (std::size_t i = 0; i < N; i++)
+            expect += std::sqrt(Float(i));
+        matlab::data::TypedArray<Float> result = pool->wait(id).peek_result()[0];
+        Assert(std::abs(result[0] - expect) < 1e-10, "unexpect result");
+
+        // at most one partial value per worker passes through the client
+        matlab::data::StructArray after = pool->get_pool_status();
+        matlab::data::TypedArray<std::uint64_t> passed0 = before[0]["PassedResults"];
+        matlab::data::TypedArray<std::uint64_t> passed1 = after[0]["PassedResults"];
+        Assert(passed1[0] - passed0[0] < pool->size(), "unexpect transfer of partial results");
+
+        // anonymous reduce function
+        inputs.assign(N, {});
+        for (std::size_t i = 0; i < N; i++)
+            inputs[i].push_back(factory.createScalar<Float>(Float(i)));
+        id = pool->map_reduce(u"sqrt", u"@(a,b)max(a,b)", std::move(inputs));
+        matlab::data::TypedArray<Float> maximum = pool->wait(id).peek_result()[0];
+        Assert(std::abs(maximum[0] - std::sqrt(Float(N - 1))) < 1e-10, "unexpect result");
+
+        UnexpectException<Pool::EmptyReduction>::check([&]() {
+            pool->map_reduce(u"sqrt", u"plus", {});
+        });
+    });
+
+    test.run("distributed array", Effort::Normal, [&]() {
+        using Float = double;
+
+        auto data = factory.createArray<Float>({ 4, N });
+        Float expect = 0;
+        for (std::size_t i = 0; i < data.getNumberOfElements(); i++)
+        {
+            data[i % 4][i / 4] = Float(i);
+            expect += Float(i);
+        }
+        DistributedID d = pool->distribute(data, 1);
+
+        // one block per worker, the blocks cover all columns
+        std::size_t cols = 0;
+        for (auto &job : pool->wait_broadcast(pool->spmd(d, u"size", 1,
+            {factory.createScalar<Float>(2)})))
+        {
+            matlab::data::TypedArray<Float> n = job.peek_result()[0];
+            cols += std::size_t(n[0]);
+        }
+        Assert(cols == N, "unexpect partition");
+
+        JobID id = pool->spmd_reduce(d, u"sum", u"plus", {factory.createCharArray("all")});
+        matlab::data::TypedArray<Float> result = pool->wait(id).peek_result()[0];
+        Assert(result[0] == expect, "unexpect result");
+
+        // anonymous reduce function
+        id = pool->spmd_reduce(d, u"max", u"@(a,b)max(a,b)",
+            {factory.createArray<Float>({0, 0}), factory.createCharArray("all")});
+        matlab::data::TypedArray<Float> maximum = pool->wait(id).peek_result()[0];
+        Assert(maximum[0] == Float(4 * N - 1), "unexpect result");
+
+        pool->free_distributed(d);
+        UnexpectException<Pool::DistributedNotExists>::check([&]() {
+            pool->free_distributed(d);
+        });
+    });
+
+    test.run("actor", Effort::Normal, [&]() {
+        using Float = double;
+
+        ActorID actor = pool->create_actor(u"struct",
+            {factory.createCharArray("n"), factory.createScalar<Float>(0)});
+        std::vector<JobID> jobid(N);
+        for (std::size_t i = 0; i < N; i++)
+            jobid[i] = pool->call_actor(actor, u"setfield", 0,
+                {factory.createCharArray("n"), factory.createScalar<Float>(Float(i))});
+        for (auto id : jobid)
+            pool->wait(id);
+
+        // the calls are evaluated in order
+        matlab::data::StructArray state = pool->fetch_actor(actor);
+        matlab::data::TypedArray<Float> n = state[0]["n"];
+        Assert(Float(N - 1) == n[0], "unexpect state");
+
+        pool->destroy_actor(actor);
+        UnexpectException<Pool::ActorNotExists>::check([&]() {
+            pool->fetch_actor(actor);
+        });
+    });
+
+    test.run("allocation-free dispatch", Effort::Huge, [&]() {
+        using Float = double;
+
+        // the jobs and their results are created and destroyed outside
+        // of the measurement
+        std::vector<std::vector<matlab::data::Array>> args(N);
+        std::vector<JobFeval> jobs;
+        std::vector<JobFeval> results;
+        std::vector<JobID> jobid(N);
+        jobs.reserve(N);
+        results.reserve(N);
+        auto prepare = [&]() {
+            jobs.clear();
+            results.clear();
+            for (std::size_t i = 0; i < N; i++)
+            {
+                args[i] = { factory.createScalar<Float>(Float(i)) };
+                auto job_args = args[i];
+                jobs.emplace_back(u"sqrt", 1, std::move(job_args));
+            }
+        };
+        auto run = [&]() {
+            for (std::size_t i = 0; i < N; i++)
+                jobid[i] = pool->submit(std::move(jobs[i]));
+            for (std::size_t i = 0; i < N; i++)
+                results.push_back(pool->wait(jobid[i]));
+        };
+        auto get_counter = [&]() {
+            matlab::data::TypedArray<std::uint64_t> val = pool->get_pool_status()[0]["HeapAllocations"];
+            return std::uint64_t(val[0]);
+        };
+
+        // the slab pools and the runtime statistics grow during the
+        // warm-up
+        for (std::size_t k = 0; k < 4; k++)
+        {
+            prepare();
+            run();
+        }
+
+        // the allocations of the same calls on a plain engine, e.g.
+        // for the result arrays (outside of our control)
+        auto engine = matlab::engine::startMATLAB(options);
+        for (std::size_t i = 0; i < N; i++)
+            engine->feval(u"sqrt", 1, args[i]);
+        std::uint64_t start = allocations;
+        for (std::size_t i = 0; i < N; i++)
+            engine->feval(u"sqrt", 1, args[i]);
+        std::uint64_t baseline = allocations - start;
+        engine.reset();
+
+        prepare();
+        std::uint64_t count = get_counter();
+        thread_allocations = 0;
+        start = allocations;
+        run();
+        std::uint64_t total = allocations - start;
+        std::uint64_t local = thread_allocations;
+
+        Assert(local == 0, "submit or wait allocates memory");
+        Assert(total <= baseline, "the dispatch allocates more memory than the engine API");
+        Assert(get_counter() == count, "the slab pools allocate memory");
+        results.clear();
+    });
+
     test.run("get worker status", Effort::Large, [&]() {
         using Float = double;
         JobID id = pool->submit(